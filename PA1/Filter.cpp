@@ -1,57 +1,69 @@
 #include "Filter.h"
+#include "ScratchArena.h"
 #include <algorithm>
 #include <cmath>
 #include <vector>
 #include <numeric>
 #include <math.h>
-#include <cmath>
-#include <omp.h>
-// Mean Filter
 #include <omp.h>
 
 #include <cmath> // For std::floor
 
-void Filter::apply_mean_filter(GrayscaleImage& image, int kernelSize) {
-    // Step 1: Copy the original image for reference.
+// All temporaries below are borrowed from the calling thread's ScratchArena, so once the arena
+// has seen the largest image of a batch the filters run without any heap allocation.
+
+// Copy the image into a contiguous row-major buffer
+static void copy_to_buffer(const GrayscaleImage& image, int* buffer) {
     int width = image.get_width();
     int height = image.get_height();
-    GrayscaleImage original_image = image;  // Copy of the original image.
+    int** data = image.get_data();
+    for (int y = 0; y < height; ++y) {
+        std::copy(data[y], data[y] + width, buffer + y * width);
+    }
+}
+
+// Mean Filter
+void Filter::apply_mean_filter(GrayscaleImage& image, int kernelSize) {
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
 
-    // Step 2: Pad the original image with black pixels (0).
+    // Step 1: Pad the original image with black pixels (0).
+    int width = image.get_width();
+    int height = image.get_height();
     int padSize = kernelSize / 2;
-    GrayscaleImage padded_image(width + 2 * padSize, height + 2 * padSize);
-
-    // Fill padded image with zeros (black)
-    for (int y = 0; y < padded_image.get_height(); ++y) {
-        for (int x = 0; x < padded_image.get_width(); ++x) {
-            if (x < padSize || x >= (width + padSize) || y < padSize || y >= (height + padSize)) {
-                padded_image.set_pixel(x, y, 0);  // Padding with black pixels
-            } else {
-                // Copy original image pixels into padded image
-                padded_image.set_pixel(x, y, original_image.get_pixel(x - padSize, y - padSize));
-            }
-        }
+    int paddedWidth = width + 2 * padSize;
+    int paddedHeight = height + 2 * padSize;
+    int* padded_image = arena.allocate_ints(static_cast<size_t>(paddedWidth) * paddedHeight);
+
+    int** data = image.get_data();
+    std::fill(padded_image, padded_image + padSize * paddedWidth, 0);
+    for (int y = 0; y < height; ++y) {
+        int* row = padded_image + (y + padSize) * paddedWidth;
+        std::fill(row, row + padSize, 0);
+        std::copy(data[y], data[y] + width, row + padSize);
+        std::fill(row + padSize + width, row + paddedWidth, 0);
     }
+    std::fill(padded_image + (height + padSize) * paddedWidth, padded_image + paddedHeight * paddedWidth, 0);
 
-    // Step 3: For each pixel, calculate the mean value of its neighbors using a kernel.
+    // Step 2: For each pixel, calculate the mean value of its neighbors using a kernel.
+    // The window is centered, -padSize..padSize in both directions, so an even kernelSize still
+    // averages (2 * padSize + 1)^2 pixels.
+    int windowSize = 2 * padSize + 1;
+    int count = windowSize * windowSize;
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
             int sum = 0;
-            int count = 0;
 
             // Iterate over the kernel
-            for (int ky = -padSize; ky <= padSize; ++ky) {
-                for (int kx = -padSize; kx <= padSize; ++kx) {
-                    // Access pixels from the padded image
-                    int pixel_value = padded_image.get_pixel(x + kx + padSize, y + ky + padSize);
-                    sum += pixel_value;
-                    count++;
+            for (int ky = 0; ky < windowSize; ++ky) {
+                const int* row = padded_image + (y + ky) * paddedWidth + x;
+                for (int kx = 0; kx < windowSize; ++kx) {
+                    sum += row[kx];
                 }
             }
 
-            // Step 4: Compute the average and update the pixel in the original image.
-            int average = sum / count;  // Integer division
-            image.set_pixel(x, y, average);  // Update the central pixel
+            // Step 3: Compute the average and update the pixel in the original image.
+            data[y][x] = sum / count;  // Integer division
         }
     }
 }
@@ -60,10 +72,9 @@ void Filter::apply_mean_filter(GrayscaleImage& image, int kernelSize) {
 
 
 
-// Helper function to create Gaussian kernel
-std::vector<std::vector<double>> create_gaussian_kernel(int kernelSize, double sigma) {
+// Helper function to fill a kernelSize x kernelSize Gaussian kernel (row-major)
+static void create_gaussian_kernel(double* kernel, int kernelSize, double sigma) {
     int padding = kernelSize / 2;
-    std::vector<std::vector<double>> kernel(kernelSize, std::vector<double>(kernelSize, 0));
     double sum = 0.0;
     double s = 2.0 * sigma * sigma;
 
@@ -72,73 +83,92 @@ std::vector<std::vector<double>> create_gaussian_kernel(int kernelSize, double s
         for (int y = -padding; y <= padding; ++y) {
             double r = sqrt(x * x + y * y);
             double value = exp(-(r * r) / s) / (M_PI * s);
-            kernel[x + padding][y + padding] = value;
+            kernel[(x + padding) * kernelSize + (y + padding)] = value;
             sum += value;
         }
     }
 
     // Normalize the kernel
-    for (int i = 0; i < kernelSize; ++i) {
-        for (int j = 0; j < kernelSize; ++j) {
-            kernel[i][j] /= sum;
-        }
+    for (int i = 0; i < kernelSize * kernelSize; ++i) {
+        kernel[i] /= sum;
     }
-
-    return kernel;
 }
 
-// Gaussian Smoothing Filter
-void Filter::apply_gaussian_smoothing(GrayscaleImage& image, int kernelSize, double sigma) {
-    int width = image.get_width();
-    int height = image.get_height();
+// Gaussian smoothing from a row-major source buffer into the destination rows
+static void gaussian_smooth(const int* source, int** destination, int width, int height,
+                            int kernelSize, double sigma, ScratchArena& arena) {
     int padding = kernelSize / 2;
 
     // 1. Create Gaussian kernel
-    std::vector<std::vector<double>> kernel = create_gaussian_kernel(kernelSize, sigma);
-
-    // 2. Copy the original image for reference
-    GrayscaleImage copy = image;
+    double* kernel = arena.allocate_doubles(static_cast<size_t>(kernelSize) * kernelSize);
+    create_gaussian_kernel(kernel, kernelSize, sigma);
 
-    // 3. Iterate over each pixel in the image
+    // 2. Iterate over each pixel in the image
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
             double sum = 0.0;
 
-            // 4. Compute the weighted sum using the Gaussian kernel
-            for (int ky = -padding; ky <= padding; ++ky) {
-                for (int kx = -padding; kx <= padding; ++kx) {
-                    int nx = x + kx;
-                    int ny = y + ky;
+            // 3. Compute the weighted sum using the Gaussian kernel, column by column: weights
+            // points at kernel row kx + padding, and each pixel (nx, ny) is weighted by its entry ky.
+            for (int kx = -padding; kx <= padding; ++kx) {
+                int nx = x + kx;
+                if (nx < 0 || nx >= width) continue;  // Check boundaries (handle edges)
 
-                    // Check boundaries (handle edges)
-                    if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                        sum += copy.get_pixel(nx, ny) * kernel[ky + padding][kx + padding];
+                const double* weights = kernel + (kx + padding) * kernelSize + padding;
+                for (int ky = -padding; ky <= padding; ++ky) {
+                    int ny = y + ky;
+                    if (ny >= 0 && ny < height) {
+                        sum += source[ny * width + nx] * weights[ky];
                     }
                 }
             }
 
-            // 5. Update the pixel values with the smoothed result
-            int newValue = static_cast<int>(sum);
-            image.set_pixel(x, y, newValue);
+            // 4. Update the pixel values with the smoothed result
+            destination[y][x] = static_cast<int>(sum);
         }
     }
 }
-#include <cmath> // For std::floor
+
+// Gaussian Smoothing Filter
+void Filter::apply_gaussian_smoothing(GrayscaleImage& image, int kernelSize, double sigma) {
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+
+    int width = image.get_width();
+    int height = image.get_height();
+
+    // Copy the original image for reference
+    int* copy = arena.allocate_ints(static_cast<size_t>(width) * height);
+    copy_to_buffer(image, copy);
+
+    gaussian_smooth(copy, image.get_data(), width, height, kernelSize, sigma, arena);
+}
 
 void Filter::apply_unsharp_mask(GrayscaleImage& image, int kernelSize, double amount) {
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+
     int width = image.get_width();
     int height = image.get_height();
+    int** data = image.get_data();
 
     // 1. Create a blurred version of the image using Gaussian smoothing
-    GrayscaleImage blurredImage = image; // Make a copy of the image
-    apply_gaussian_smoothing(blurredImage, kernelSize, 1.0); // sigma = 1.0
+    int* original = arena.allocate_ints(static_cast<size_t>(width) * height);
+    copy_to_buffer(image, original);
+
+    int** blurredImage = static_cast<int**>(arena.allocate(height * sizeof(int*)));
+    int* blurredPixels = arena.allocate_ints(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        blurredImage[y] = blurredPixels + y * width;
+    }
+    gaussian_smooth(original, blurredImage, width, height, kernelSize, 1.0, arena); // sigma = 1.0
 
     // 2. Iterate over each pixel in the image to apply the unsharp mask formula
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
             // Get the original and blurred pixel values
-            int originalPixel = image.get_pixel(x, y);
-            int blurredPixel = blurredImage.get_pixel(x, y);
+            int originalPixel = original[y * width + x];
+            int blurredPixel = blurredImage[y][x];
 
             // 3. Calculate the "edge" or "high-frequency" component: original - blurred
             int edgeComponent = originalPixel - blurredPixel;
@@ -150,13 +180,65 @@ void Filter::apply_unsharp_mask(GrayscaleImage& image, int kernelSize, double am
             sharpenedPixel = std::floor(sharpenedPixel);
 
             // 6. Clip the pixel value to stay within the valid range [0, 255]
-            sharpenedPixel = std::max(0, std::min(255, static_cast<int>(sharpenedPixel)));
-
-            // 7. Set the sharpened pixel value in the image
-            image.set_pixel(x, y, sharpenedPixel);
+            data[y][x] = std::max(0, std::min(255, static_cast<int>(sharpenedPixel)));
         }
     }
 }
 
+// Linear Contrast Stretch
+void Filter::apply_contrast_stretch(GrayscaleImage& image, double clipPercent) {
+    ImageStatistics stats = image.compute_statistics();
+    if (stats.pixel_count == 0) return;
+
+    // 1. Find the intensities below/above which clipPercent of the pixels lie
+    uint64_t clipCount = static_cast<uint64_t>(stats.pixel_count * std::max(0.0, clipPercent) / 100.0);
+    int low = 0, high = 255;
+    uint64_t seen = 0;
+    while (low < 255 && seen + stats.histogram[low] <= clipCount) {
+        seen += stats.histogram[low++];
+    }
+    seen = 0;
+    while (high > 0 && seen + stats.histogram[high] <= clipCount) {
+        seen += stats.histogram[high--];
+    }
+    if (high <= low) return;  // Flat image, nothing to stretch
 
+    // 2. Map [low, high] linearly onto [0, 255]
+    std::array<int, 256> lut;
+    for (int v = 0; v < 256; ++v) {
+        int stretched = (v - low) * 255 / (high - low);
+        lut[v] = std::max(0, std::min(255, stretched));
+    }
+    image.apply_lookup_table(lut);
+}
 
+// Histogram Equalization
+void Filter::apply_histogram_equalization(GrayscaleImage& image) {
+    ImageStatistics stats = image.compute_statistics();
+    if (stats.pixel_count == 0) return;
+
+    // 1. Cumulative distribution, skipping the empty bins before the first intensity in use
+    std::array<uint64_t, 256> cdf;
+    uint64_t running = 0;
+    for (int v = 0; v < 256; ++v) {
+        running += stats.histogram[v];
+        cdf[v] = running;
+    }
+    uint64_t cdfMin = 0;
+    for (int v = 0; v < 256 && cdfMin == 0; ++v) {
+        cdfMin = cdf[v];
+    }
+    uint64_t total = static_cast<uint64_t>(stats.pixel_count);
+    if (total == cdfMin) return;  // Single intensity, nothing to equalize
+
+    // 2. Map every intensity to its rank in the distribution
+    std::array<int, 256> lut;
+    for (int v = 0; v < 256; ++v) {
+        if (cdf[v] < cdfMin) {
+            lut[v] = 0;
+        } else {
+            lut[v] = static_cast<int>(std::lround(static_cast<double>(cdf[v] - cdfMin) * 255.0 / (total - cdfMin)));
+        }
+    }
+    image.apply_lookup_table(lut);
+}
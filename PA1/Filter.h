@@ -21,6 +21,15 @@ public:
     // @param kernelSize: Size of the Gaussian kernel for smoothing (should be odd), default is 3
     // @param amount: The amount of sharpening to apply, default is 1.5
     static void apply_unsharp_mask(GrayscaleImage& image, int kernelSize = 3, double amount = 1.5);
+
+    // Apply Linear Contrast Stretch
+    // @param image: The grayscale image to stretch to the full [0, 255] range
+    // @param clipPercent: Percentage of pixels saturated at each end before stretching, default is 0
+    static void apply_contrast_stretch(GrayscaleImage& image, double clipPercent = 0.0);
+
+    // Apply Histogram Equalization
+    // @param image: The grayscale image whose intensity distribution is flattened
+    static void apply_histogram_equalization(GrayscaleImage& image);
 };
 
 #endif // FILTER_H
@@ -1,4 +1,5 @@
 #include "GrayscaleImage.h"
+#include "ImageLoader.h"
 #include <iostream>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -7,6 +8,7 @@
 #include "stb_image_write.h"
 #include <stdexcept>
 #include <algorithm>
+#include <string>
 
 GrayscaleImage::GrayscaleImage(const char* filename) {
     // Image loading code using stbi
@@ -14,33 +16,28 @@ GrayscaleImage::GrayscaleImage(const char* filename) {
     unsigned char* image = stbi_load(filename, &width, &height, &channels, STBI_grey);
 
     if (image == nullptr) {
-        std::cerr << "Error: Could not load image " << filename << std::endl;
-        exit(1);
+        throw std::runtime_error(std::string("Could not load image ") + filename);
     }
 
-    // Dynamically allocate memory for the 2D array
-    data = new int*[height];
-    for (int i = 0; i < height; ++i) {
-        data[i] = new int[width];
-    }
+    // Allocate one contiguous block for the pixels plus the row pointers
+    allocate();
 
     // Fill the matrix with pixel values from the image
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            data[i][j] = image[i * width + j];  // Access the 1D array as a 2D matrix
-        }
-    }
+    std::copy(image, image + width * height, pixels);
 
     // Free the dynamically allocated memory of stbi image
     stbi_image_free(image);
 }
+// Constructor: take ownership of a decoded buffer, e.g. one produced by AsyncImageLoader
+GrayscaleImage::GrayscaleImage(int* adoptedPixels, int w, int h, std::shared_ptr<ImageBufferPool> pool,
+                               size_t capacity)
+        : pixels(adoptedPixels), width(w), height(h), pool(std::move(pool)), capacity(capacity) {
+    data = new int*[height];
+    link_rows();
+}
 // Constructor: initialize from a pre-existing data matrix
 GrayscaleImage::GrayscaleImage(int** inputData, int h, int w) : width(w), height(h) {
-    // Dynamically allocate memory for the matrix
-    data = new int*[height];
-    for (int i = 0; i < height; ++i) {
-        data[i] = new int[width];
-    }
+    allocate();
 
     // Copy the values from inputData to data
     for (int i = 0; i < height; ++i) {
@@ -48,40 +45,47 @@ GrayscaleImage::GrayscaleImage(int** inputData, int h, int w) : width(w), height
     }
 }
 GrayscaleImage::GrayscaleImage(int w, int h) : width(w), height(h) {
-    // Dynamically allocate memory for the matrix
-    data = new int*[height];
-    for (int i = 0; i < height; ++i) {
-        data[i] = new int[width];
-    }
+    allocate();
 
     // Initialize all pixel values to 0 (black)
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            data[i][j] = 0;
-        }
-    }
+    std::fill(pixels, pixels + width * height, 0);
 }
 GrayscaleImage::GrayscaleImage(const GrayscaleImage& other) : width(other.width), height(other.height) {
-    // Dynamically allocate memory for the matrix
-    data = new int*[height];
-    for (int i = 0; i < height; ++i) {
-        data[i] = new int[width];
-    }
+    allocate();
 
     // Copy the pixel values from the other image
     for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            data[i][j] = other.data[i][j];
-        }
+        std::memcpy(data[i], other.data[i], width * sizeof(int));
     }
 }
+GrayscaleImage::GrayscaleImage(GrayscaleImage&& other) noexcept
+        : data(other.data), pixels(other.pixels), width(other.width), height(other.height),
+          pool(std::move(other.pool)), capacity(other.capacity) {
+    other.data = nullptr;
+    other.capacity = 0;
+    other.pixels = nullptr;
+    other.width = 0;
+    other.height = 0;
+}
 GrayscaleImage::~GrayscaleImage() {
     // Deallocate memory for the 2D matrix
-    for (int i = 0; i < height; ++i) {
-        delete[] data[i];
+    if (pool) {
+        pool->release(pixels, capacity);
+    } else {
+        delete[] pixels;
     }
     delete[] data;
 }
+void GrayscaleImage::allocate() {
+    pixels = new int[static_cast<size_t>(width) * height];
+    data = new int*[height];
+    link_rows();
+}
+void GrayscaleImage::link_rows() {
+    for (int i = 0; i < height; ++i) {
+        data[i] = pixels + static_cast<size_t>(i) * width;
+    }
+}
 // Get a specific pixel value
 int GrayscaleImage::get_pixel(int row, int col) const {
     return data[row][col];
@@ -155,3 +159,73 @@ GrayscaleImage GrayscaleImage::operator-(const GrayscaleImage& other) const {
     return result;
 }
 
+
+void ImageStatistics::merge(const ImageStatistics& other) {
+    if (other.pixel_count == 0) return;
+    if (pixel_count == 0) {
+        *this = other;
+        return;
+    }
+
+    // Combine the moments (parallel variance formula), then the histograms
+    long long total = pixel_count + other.pixel_count;
+    double delta = other.mean - mean;
+    double m2 = variance * pixel_count + other.variance * other.pixel_count +
+                delta * delta * pixel_count * other.pixel_count / total;
+    mean += delta * other.pixel_count / total;
+    variance = m2 / total;
+    pixel_count = total;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    for (int i = 0; i < 256; ++i) {
+        histogram[i] += other.histogram[i];
+    }
+}
+
+ImageStatistics GrayscaleImage::compute_statistics() const {
+    ImageStatistics stats;
+    long long count = static_cast<long long>(width) * height;
+    if (count == 0) return stats;
+
+    long long sum = 0, sum_squares = 0;
+    int min_value = pixels[0], max_value = pixels[0];
+
+    #pragma omp parallel
+    {
+        // Each thread keeps four interleaved sub-histograms, so consecutive equal pixels
+        // do not serialize on the same counter; they are merged once at the end.
+        uint32_t local[4][256] = {};
+
+        #pragma omp for reduction(+:sum, sum_squares) reduction(min:min_value) reduction(max:max_value)
+        for (long long i = 0; i < count; ++i) {
+            int value = pixels[i];
+            sum += value;
+            sum_squares += static_cast<long long>(value) * value;
+            min_value = std::min(min_value, value);
+            max_value = std::max(max_value, value);
+            local[i & 3][std::min(255, std::max(0, value))]++;
+        }
+
+        #pragma omp critical
+        for (int v = 0; v < 256; ++v) {
+            stats.histogram[v] += static_cast<uint64_t>(local[0][v]) + local[1][v] + local[2][v] + local[3][v];
+        }
+    }
+
+    stats.pixel_count = count;
+    stats.min = min_value;
+    stats.max = max_value;
+    stats.mean = static_cast<double>(sum) / count;
+    stats.variance = static_cast<double>(sum_squares) / count - stats.mean * stats.mean;
+    if (stats.variance < 0.0) stats.variance = 0.0;  // Rounding on near-constant images
+    return stats;
+}
+
+void GrayscaleImage::apply_lookup_table(const std::array<int, 256>& lut) {
+    long long count = static_cast<long long>(width) * height;
+
+    #pragma omp parallel for
+    for (long long i = 0; i < count; ++i) {
+        pixels[i] = lut[std::min(255, std::max(0, pixels[i]))];
+    }
+}
@@ -1,15 +1,47 @@
 #ifndef GRAYSCALE_IMAGE_H
 #define GRAYSCALE_IMAGE_H
 
+#include <array>
+#include <cstdint>
+#include <memory>
+
+class ImageBufferPool;
+
+// Global statistics of an image, gathered in a single pass by GrayscaleImage::compute_statistics()
+struct ImageStatistics {
+    std::array<uint64_t, 256> histogram{};  // Pixel counts per intensity, values clamped to [0, 255]
+    long long pixel_count = 0;
+    int min = 0, max = 0;  // Smallest and largest pixel values
+    double mean = 0.0;
+    double variance = 0.0;  // Population variance
+
+    // Add the counts and moments of another (disjoint) region into this one
+    void merge(const ImageStatistics& other);
+};
+
 class GrayscaleImage {
 private:
-    int** data;  // 2D array for storing pixel values
+    int** data;  // 2D array for storing pixel values (row pointers into pixels)
+    int* pixels = nullptr;  // Contiguous row-major pixel storage
     int width{}, height{};  // Image dimensions
+    std::shared_ptr<ImageBufferPool> pool;  // Owner of pixels when adopted from a loader, null otherwise
+    size_t capacity = 0;  // Size of pixels as allocated by the pool, which may exceed width * height
+
+    // Allocate pixel storage and row pointers for the current width and height
+    void allocate();
+
+    // Point each row of data into the contiguous pixel buffer
+    void link_rows();
 
 public:
     // Constructor: loads an image from a file
+    // Throws std::runtime_error if the file cannot be decoded
     GrayscaleImage(const char* filename);
 
+    // Constructor: adopts an already decoded row-major buffer without copying it.
+    // The buffer is handed back to the pool with its capacity (or delete[]'d when pool is null) on destruction.
+    GrayscaleImage(int* adoptedPixels, int w, int h, std::shared_ptr<ImageBufferPool> pool, size_t capacity);
+
     // Constructor: initializes from a 2D data matrix
     GrayscaleImage(int** inputData, int h, int w);
 
@@ -18,6 +50,9 @@ public:
 
     // Copy constructor
     GrayscaleImage(const GrayscaleImage& other);
+
+    // Move constructor
+    GrayscaleImage(GrayscaleImage&& other) noexcept;
     GrayscaleImage(int w, int h, int initialValue);
 
     // Destructor
@@ -38,6 +73,12 @@ public:
     // Set a specific pixel value at (row, col)
     void set_pixel(int row, int col, int value);
 
+    // Compute histogram, min/max, mean and variance in one sweep over the pixels
+    ImageStatistics compute_statistics() const;
+
+    // Replace every pixel p with lut[clamp(p, 0, 255)]
+    void apply_lookup_table(const std::array<int, 256>& lut);
+
     // Function to save the image to a PNG file
     void save_to_file(const char* filename) const;
 
@@ -0,0 +1,147 @@
+#include "ImageLoader.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <stdexcept>
+
+ImageBufferPool::~ImageBufferPool() {
+    for (const Buffer& buffer : free_buffers) {
+        delete[] buffer.memory;
+    }
+}
+
+int* ImageBufferPool::acquire(size_t count, size_t& capacity) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Reuse the smallest free buffer that is large enough
+        auto best = free_buffers.end();
+        for (auto it = free_buffers.begin(); it != free_buffers.end(); ++it) {
+            if (it->capacity >= count && (best == free_buffers.end() || it->capacity < best->capacity)) {
+                best = it;
+            }
+        }
+        if (best != free_buffers.end()) {
+            int* memory = best->memory;
+            capacity = best->capacity;
+            *best = free_buffers.back();
+            free_buffers.pop_back();
+            return memory;
+        }
+    }
+    capacity = count;
+    return new int[count];
+}
+
+void ImageBufferPool::release(int* buffer, size_t capacity) {
+    if (buffer == nullptr) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    free_buffers.push_back({buffer, capacity});
+}
+
+AsyncImageLoader::AsyncImageLoader(const std::vector<std::string>& filenames, size_t prefetch, size_t threads)
+        : filenames(filenames), pool(std::make_shared<ImageBufferPool>()), slots(std::max<size_t>(prefetch, 1)) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, slots.size());
+
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&AsyncImageLoader::worker, this);
+    }
+}
+
+AsyncImageLoader::~AsyncImageLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    slot_free.notify_all();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    // Hand back buffers that were decoded but never consumed
+    for (Slot& slot : slots) {
+        if (slot.ready) {
+            pool->release(slot.pixels, slot.capacity);
+        }
+    }
+}
+
+bool AsyncImageLoader::has_next() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return next_to_return < filenames.size();
+}
+
+GrayscaleImage AsyncImageLoader::next() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (next_to_return >= filenames.size()) {
+        throw std::out_of_range("No more images to load");
+    }
+
+    Slot& slot = slots[next_to_return % slots.size()];
+    slot_ready.wait(lock, [&] { return slot.ready && slot.index == next_to_return; });
+
+    // Take the result out of the slot and let a worker refill it
+    int* pixels = slot.pixels;
+    size_t capacity = slot.capacity;
+    int width = slot.width, height = slot.height;
+    std::string error = std::move(slot.error);
+    slot.ready = false;
+    slot.pixels = nullptr;
+    slot.capacity = 0;
+    slot.error.clear();
+    ++next_to_return;
+    lock.unlock();
+    slot_free.notify_all();
+
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+    return GrayscaleImage(pixels, width, height, pool, capacity);
+}
+
+void AsyncImageLoader::worker() {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Only decode within the prefetch window ahead of the consumer
+            slot_free.wait(lock, [&] {
+                return stopping || next_to_decode >= filenames.size() ||
+                       next_to_decode < next_to_return + slots.size();
+            });
+            if (stopping || next_to_decode >= filenames.size()) {
+                return;
+            }
+            index = next_to_decode++;
+        }
+
+        Slot result;
+        result.index = index;
+        decode(filenames[index], result);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Slot& slot = slots[index % slots.size()];
+            slot = std::move(result);
+            slot.ready = true;
+        }
+        slot_ready.notify_all();
+    }
+}
+
+void AsyncImageLoader::decode(const std::string& filename, Slot& slot) {
+    int channels;
+    unsigned char* image = stbi_load(filename.c_str(), &slot.width, &slot.height, &channels, STBI_grey);
+    if (image == nullptr) {
+        slot.error = "Could not load image " + filename;
+        slot.width = slot.height = 0;
+        return;
+    }
+
+    // Widen to int on this thread, straight into the buffer the image will adopt
+    size_t count = static_cast<size_t>(slot.width) * slot.height;
+    slot.pixels = pool->acquire(count, slot.capacity);
+    std::copy(image, image + count, slot.pixels);
+    stbi_image_free(image);
+}
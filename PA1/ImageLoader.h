@@ -0,0 +1,92 @@
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GrayscaleImage.h"
+
+// Thread-safe free list of pixel buffers shared between the loader threads and the images they produce.
+// Buffers are recycled by size, so a directory of same-sized images reaches a steady state without new allocations.
+class ImageBufferPool {
+public:
+    ImageBufferPool() = default;
+    ~ImageBufferPool();
+
+    ImageBufferPool(const ImageBufferPool&) = delete;
+    ImageBufferPool& operator=(const ImageBufferPool&) = delete;
+
+    // Borrow a buffer that can hold at least count pixels; capacity receives its real size,
+    // which may be larger than count when a free buffer is reused
+    int* acquire(size_t count, size_t& capacity);
+
+    // Return a buffer previously obtained from acquire(), with the capacity acquire() reported
+    void release(int* buffer, size_t capacity);
+
+private:
+    struct Buffer {
+        int* memory;
+        size_t capacity;
+    };
+
+    std::mutex mutex;
+    std::vector<Buffer> free_buffers;
+};
+
+// Decodes a list of image files on background threads, keeping up to `prefetch` images ready ahead
+// of the consumer. Images are returned in input order and adopt their pooled buffer without a copy.
+class AsyncImageLoader {
+public:
+    // @param filenames: Images to decode, in the order next() will return them
+    // @param prefetch: Number of images that may be decoded ahead of the consumer
+    // @param threads: Number of decoder threads, 0 picks the hardware concurrency
+    AsyncImageLoader(const std::vector<std::string>& filenames, size_t prefetch = 4, size_t threads = 0);
+
+    // Stops the decoder threads; images already returned stay valid
+    ~AsyncImageLoader();
+
+    AsyncImageLoader(const AsyncImageLoader&) = delete;
+    AsyncImageLoader& operator=(const AsyncImageLoader&) = delete;
+
+    // True while there are images left to return
+    bool has_next() const;
+
+    // Returns the next image, waiting for its decode if necessary
+    // Throws std::runtime_error if that image failed to load
+    GrayscaleImage next();
+
+private:
+    struct Slot {
+        size_t index = 0;       // Which file this slot currently holds
+        bool ready = false;
+        int* pixels = nullptr;
+        size_t capacity = 0;    // Real size of pixels, as reported by the pool
+        int width = 0, height = 0;
+        std::string error;
+    };
+
+    // Body of each decoder thread
+    void worker();
+
+    // Decode one file into a pooled buffer, recording failures in the slot
+    void decode(const std::string& filename, Slot& slot);
+
+    std::vector<std::string> filenames;
+    std::shared_ptr<ImageBufferPool> pool;
+    std::vector<Slot> slots;  // Ring of prefetched results, file i lives in slots[i % slots.size()]
+    std::vector<std::thread> workers;
+
+    mutable std::mutex mutex;
+    std::condition_variable slot_ready;  // Signalled by workers when a decode finishes
+    std::condition_variable slot_free;   // Signalled by the consumer when a slot is taken
+    size_t next_to_decode = 0;
+    size_t next_to_return = 0;
+    bool stopping = false;
+};
+
+#endif // IMAGE_LOADER_H
@@ -0,0 +1,95 @@
+#include "ScratchArena.h"
+#include <new>
+
+namespace {
+    const size_t ALIGNMENT = 64;
+    const size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+    size_t align_up(size_t value) {
+        return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    char* allocate_block(size_t size) {
+        return static_cast<char*>(::operator new(size, std::align_val_t(ALIGNMENT)));
+    }
+
+    void free_block(char* memory) {
+        ::operator delete(memory, std::align_val_t(ALIGNMENT));
+    }
+}
+
+ScratchArena::Scope::Scope(ScratchArena& arena) : arena(arena), block(arena.current), offset(arena.offset) {
+}
+
+ScratchArena::Scope::~Scope() {
+    arena.release(block, offset);
+}
+
+ScratchArena::~ScratchArena() {
+    for (const Block& b : blocks) {
+        free_block(b.memory);
+    }
+}
+
+// Each thread gets its own arena, so filters running in parallel never share buffers
+ScratchArena& ScratchArena::local() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+void* ScratchArena::allocate(size_t bytes) {
+    bytes = align_up(bytes == 0 ? 1 : bytes);
+
+    // Fast path: the request fits in the block we are currently using
+    if (!blocks.empty() && offset + bytes <= blocks[current].size) {
+        void* result = blocks[current].memory + offset;
+        offset += bytes;
+        return result;
+    }
+
+    // Move on to the next block if one is already reserved and large enough
+    size_t next = blocks.empty() ? 0 : current + 1;
+    if (next < blocks.size() && blocks[next].size >= bytes) {
+        current = next;
+        offset = bytes;
+        return blocks[current].memory;
+    }
+
+    // Otherwise drop the unused tail and reserve a bigger block
+    while (blocks.size() > next) {
+        free_block(blocks.back().memory);
+        blocks.pop_back();
+    }
+    size_t size = blocks.empty() ? MIN_BLOCK_SIZE : blocks.back().size * 2;
+    if (size < bytes) {
+        size = align_up(bytes);
+    }
+    blocks.push_back({allocate_block(size), size});
+    current = next;
+    offset = bytes;
+    return blocks[current].memory;
+}
+
+size_t ScratchArena::capacity() const {
+    size_t total = 0;
+    for (const Block& b : blocks) {
+        total += b.size;
+    }
+    return total;
+}
+
+void ScratchArena::release(size_t block, size_t offset) {
+    current = block;
+    this->offset = offset;
+
+    // When the outermost scope closes after an overflow, replace all blocks with a single one
+    // large enough for the whole working set, so the next round runs without any overflow.
+    if (block == 0 && offset == 0 && blocks.size() > 1) {
+        size_t total = capacity();
+        for (const Block& b : blocks) {
+            free_block(b.memory);
+        }
+        blocks.clear();
+        blocks.push_back({allocate_block(total), total});
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// Per-thread bump allocator for short-lived filter temporaries.
+// Buffers handed out by the arena stay valid until the enclosing Scope is destroyed.
+// Once the arena has grown to the largest working set it has seen, later requests
+// are served from the same block without touching the heap.
+class ScratchArena {
+public:
+    // Restores the arena to the position it had when the scope was opened
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScratchArena& arena;
+        size_t block;
+        size_t offset;
+    };
+
+    ScratchArena() = default;
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Returns the arena owned by the calling thread
+    static ScratchArena& local();
+
+    // Borrow an uninitialized buffer of count elements
+    int* allocate_ints(size_t count) { return static_cast<int*>(allocate(count * sizeof(int))); }
+    double* allocate_doubles(size_t count) { return static_cast<double*>(allocate(count * sizeof(double))); }
+
+    // Borrow an uninitialized, 64-byte aligned block of the given size
+    void* allocate(size_t bytes);
+
+    // Total bytes reserved from the heap so far
+    size_t capacity() const;
+
+private:
+    struct Block {
+        char* memory;
+        size_t size;
+    };
+
+    // Rewind to a previous position; merges overflow blocks once the arena is empty
+    void release(size_t block, size_t offset);
+
+    std::vector<Block> blocks;  // blocks[0..current] are in use, in allocation order
+    size_t current = 0;         // Index of the block we are bumping in
+    size_t offset = 0;          // Bytes used in the current block
+};
+
+#endif // SCRATCH_ARENA_H
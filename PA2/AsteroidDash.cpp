@@ -1,15 +1,19 @@
 #include "AsteroidDash.h"
+#include "TickProfiler.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+LogLevel AsteroidDash::log_level = LOG_OFF;
+
 // Constructor to initialize AsteroidDash with the given parameters
 AsteroidDash::AsteroidDash(const string &space_grid_file_name,
                            const string &celestial_objects_file_name,
                            const string &leaderboard_file_name,
                            const string &player_file_name,
                            const string &player_name)
-    : leaderboard_file_name(leaderboard_file_name), leaderboard(Leaderboard()) {
+    : level(make_shared<LevelData>()), leaderboard_file_name(leaderboard_file_name), leaderboard(Leaderboard()) {
 
     read_player(player_file_name, player_name);
     read_space_grid(space_grid_file_name);
@@ -17,235 +21,223 @@ AsteroidDash::AsteroidDash(const string &space_grid_file_name,
     leaderboard.read_from_file(leaderboard_file_name);
 }
 
-// Function to read the space grid from a file
-void AsteroidDash::read_space_grid(const string &input_file) {
-    ifstream file(input_file);
-    if (!file.is_open()) {
-        cerr << "Failed to open space grid file." << endl;
-        return;
-    }
-
-    int value;
-    vector<int> row;
-    while (file >> value) {
-        row.push_back(value);
-        if (file.peek() == '\n' || file.eof()) {
-            space_grid.push_back(row);
-            row.clear();
-        }
+// Constructor to start a game on an already loaded level; no file is read
+AsteroidDash::AsteroidDash(shared_ptr<LevelData> level, const string &player_name) : level(std::move(level)) {
+    if (this->level->has_player) {
+        init_player(player_name);
     }
+    init_grid();
+    init_objects();
+}
 
-    int grid_height = space_grid.size();
-    int grid_width = space_grid[0].size();
-    file.close();
+// Function to read the space grid from a file
+void AsteroidDash::read_space_grid(const string &input_file) {
+    level->read_space_grid(input_file);
+    init_grid();
 }
 
 // Function to read the player from a file
 void AsteroidDash::read_player(const string &player_file_name, const string &player_name) {
-    ifstream file(player_file_name);
-
-    // Check if the file opened successfully
-    if (!file.is_open()) {
-        cerr << "Error: Unable to open player file: " << player_file_name << endl;
-        return;
-    }
-
-    // Read the initial position (row and column) from the first line
-    int row, col;
-    file >> row >> col;
-
-    // Read the spacecraft shape from the subsequent lines
-    vector<vector<bool>> shape;
-    string line;
-    while (getline(file, line)) {
-        if (line.empty()) continue;  // Skip any empty lines
-
-        vector<bool> spacecraft_row;
-        for (char ch : line) {
-            if (ch == '1') {
-                spacecraft_row.push_back(true);
-            } else if (ch == '0') {
-                spacecraft_row.push_back(false);
-            }
-        }
-        shape.push_back(spacecraft_row);
+    if (level->read_player(player_file_name)) {
+        init_player(player_name);
     }
-
-    // Create a new Player instance with the read data
-    player = new Player(shape, row, col, player_name);
-
-    file.close();
 }
 
-
 // Function to read celestial objects from a file
 void AsteroidDash::read_celestial_objects(const string &input_file) {
-    ifstream file(input_file);
-
-    // Check if the file opened successfully
-    if (!file.is_open()) {
-        cerr << "Error: Unable to open celestial objects file: " << input_file << endl;
-        return;
-    }
+    level->read_celestial_objects(input_file);
+    init_objects();
+}
 
-    string line;
+void AsteroidDash::init_grid() {
+    space_grid.resize(level->grid_height, level->grid_width);
+    dirty_rows.assign(level->grid_height, 0);
+    dirty_row_list.clear();
+    player_on_grid = false;
 
-    // Check the first line before entering the loop
-    if (getline(file, line)) {
-        cout << "First line read: " << line << endl;  // Debug print to check the first line
-    }
+    // Active objects span at most the grid plus one shape width on either side
+    column_index.reset(level->grid_width + 2 * 64);
+}
 
-    // Read the file line by line
-    while (getline(file, line)) {
-        // Skip any empty lines
-        if (line.empty()) continue;
-
-        // Trim leading/trailing whitespace (if any)
-        line = line.substr(line.find_first_not_of(" \t"), line.find_last_not_of(" \t") + 1);
-        cout << "Processing line: " << line << endl;  // Debug print
-
-        // Check if it's an object shape (either an asteroid or a power-up)
-        if (line.front() == '[' || line.front() == '{') {
-            // Read the shape matrix
-            vector<vector<bool>> shape;
-            char delimiter = (line.front() == '[') ? ']' : '}';  // Determine if it's asteroid or power-up
-            bool is_asteroid = (line.front() == '[');
-
-            // Read the 2D shape matrix until the closing bracket
-            do {
-                cout << "Reading shape line: " << line << endl;  // Debug print for shape line
-                vector<bool> row;
-                for (char ch : line) {
-                    if (ch == '1') {
-                        row.push_back(true);
-                    } else if (ch == '0') {
-                        row.push_back(false);
-                    }
-                }
-                shape.push_back(row);
-            } while (getline(file, line) && line.front() != delimiter);
-
-            cout << "Shape matrix read complete. Rows: " << shape.size() << endl;
-
-            // Read the metadata: starting row (s), tick (t), and effect (e) if applicable
-            int starting_row = -1, time_of_appearance = -1;
-            string effect;
-            while (getline(file, line)) {
-                if (line.empty()) continue;
-
-                cout << "Reading metadata line: " << line << endl;  // Debug print for metadata line
-
-                if (line[0] == 's') {  // Starting row
-                    stringstream ss(line.substr(2));  // Skip "s: "
-                    ss >> starting_row;
-                    cout << "Parsed starting row: " << starting_row << endl;
-                } else if (line[0] == 't') {  // Time of appearance
-                    stringstream ss(line.substr(2));  // Skip "t: "
-                    ss >> time_of_appearance;
-                    cout << "Parsed time of appearance: " << time_of_appearance << endl;
-                } else if (line[0] == 'e') {  // Effect for power-ups (Life-Up or Ammo)
-                    if (!is_asteroid) {
-                        effect = line.substr(2);  // Skip "e: "
-                        cout << "Parsed effect: " << effect << endl;
-                    }
-                }
+void AsteroidDash::init_player(const string &player_name) {
+    delete player;
+    player = new Player(level->player_masks, level->player_width, level->player_row, level->player_col, player_name);
+    initial_player_lives = player->lives;
+    player_on_grid = false;
+}
 
-                // If all necessary metadata has been read, we can break out of this loop
-                if (starting_row != -1 && time_of_appearance != -1 &&
-                    (is_asteroid || !effect.empty())) {
-                    break;
-                }
-            }
+void AsteroidDash::init_objects() {
+    celestial_objects_list_head = level->celestial_objects_list_head;
+    celestial_store.reset(*level);
+    spawn_scheduler.reset();
+    active_objects.clear();
+}
 
-            // Convert the effect to ObjectType (LIFE_UP or AMMO) if it's a power-up
-            ObjectType object_type = ASTEROID;  // Default type is ASTEROID
-            if (!is_asteroid) {
-                if (effect == "life") {
-                    object_type = LIFE_UP;
-                } else if (effect == "ammo") {
-                    object_type = AMMO;
-                }
-            }
+// Print the entire space grid
+void AsteroidDash::print_space_grid() const {
+    frame_renderer.render(space_grid);
+}
 
-            // Create a new CelestialObject with the data read
-            CelestialObject *new_object = new CelestialObject(shape, object_type, starting_row, time_of_appearance);
+// Function to update the space grid with player, celestial objects, and any other changes.
+// Only footprints that changed since the last call are erased and repainted.
+void AsteroidDash::update_space_grid() {
+    // Move the player's footprint only if the player moved
+    bool player_moved = false;
+    if (player && (!player_on_grid || player_grid_row != player->position_row ||
+                   player_grid_col != player->position_col)) {
+        const uint64_t *masks = player->shape_masks.data();
+        int mask_rows = player->shape_masks.size();
+        if (player_on_grid) {
+            space_grid.erase(PLAYER_PLANE, player_grid_row, player_grid_col, masks, mask_rows);
+        }
+        space_grid.stamp(PLAYER_PLANE, player->position_row, player->position_col, masks, mask_rows);
+        player_on_grid = true;
+        player_grid_row = player->position_row;
+        player_grid_col = player->position_col;
+        player_moved = true;
+    }
 
-            // Add this new object to the linked list
-            if (celestial_objects_list_head == nullptr) {
-                celestial_objects_list_head = new_object;  // Set the head of the list
+    // Bring in the objects whose time has come
+    spawn_scheduler.promote(game_time, *level, active_objects);
+    painted_time = game_time;
+
+    // Update active objects; those that were destroyed or left the grid are retired.
+    // Survivors are compacted in place, so the active set stays in store order.
+    CelestialStore &store = celestial_store;
+    size_t kept = 0;
+    for (size_t i = 0; i < active_objects.size(); ++i) {
+        int object = active_objects[i];
+        int row = level->starting_row[object];
+        int col = object_column(object);
+        int mask_rows = level->shape_arena.height(store.shape_id[object]);
+        bool retired = !store.alive[object] || col + level->shape_arena.width(store.shape_id[object]) <= 0;
+
+        if (store.on_grid[object] && (retired || store.shape_changed[object] ||
+                                      row != store.grid_row[object] || col != store.grid_col[object])) {
+            mark_rows_dirty(store.grid_row[object], store.grid_rows[object]);
+            store.on_grid[object] = 0;
+        }
+        if (!retired && !store.on_grid[object]) {
+            // Collision with the player is a per-row AND against the player plane
+            if (collision_rules && player &&
+                space_grid.overlaps(PLAYER_PLANE, row, col, store.masks(object, level->shape_arena), mask_rows)) {
+                handle_collision(object);
+                retired = true;
             } else {
-                CelestialObject *temp = celestial_objects_list_head;
-                while (temp->next_celestial_object != nullptr) {
-                    temp = temp->next_celestial_object;
+                store.on_grid[object] = 1;
+                store.grid_row[object] = row;
+                store.grid_col[object] = col;
+                store.grid_rows[object] = mask_rows;
+                mark_rows_dirty(row, mask_rows);
+                if (store.indexed_width[object] != level->shape_arena.width(store.shape_id[object])) {
+                    reindex_object(object, level->shape_arena.width(store.shape_id[object]));
                 }
-                temp->next_celestial_object = new_object;  // Linking the new object to the list
             }
+        }
+        store.shape_changed[object] = 0;
 
-            // Debug print for verifying linked list addition
-            cout << "Added new object with starting_row: " << starting_row
-                 << " and time_of_appearance: " << time_of_appearance << endl;
-
-            // Manual rotations code remains unchanged...
+        if (!retired) {
+            active_objects[kept++] = object;
+        } else {
+            reindex_object(object, 0);
+            store.retire(object);
         }
     }
-
-    file.close();
-    cout << "File reading complete." << endl;  // Debug print
+    active_objects.resize(kept);
+    repaint_dirty_rows();
+
+    // A player that moved onto objects that stayed put collides with them too
+    if (collision_rules && player_moved && space_grid.overlaps(OBJECT_PLANE, player->position_row, player->position_col,
+                                            player->shape_masks.data(), player->shape_masks.size())) {
+        kept = 0;
+        for (size_t i = 0; i < active_objects.size(); ++i) {
+            int object = active_objects[i];
+            if (space_grid.overlaps(PLAYER_PLANE, store.grid_row[object], store.grid_col[object],
+                                    store.masks(object, level->shape_arena), store.grid_rows[object])) {
+                handle_collision(object);
+                store.on_grid[object] = 0;
+                mark_rows_dirty(store.grid_row[object], store.grid_rows[object]);
+                reindex_object(object, 0);
+                store.retire(object);
+            } else {
+                active_objects[kept++] = object;
+            }
+        }
+        active_objects.resize(kept);
+        repaint_dirty_rows();
+    }
 }
 
+int AsteroidDash::object_column(int object) const {
+    long elapsed = static_cast<long>(game_time) - level->spawn_tick[object];
+    return static_cast<int>(space_grid.get_width() - 1 - elapsed);
+}
 
+long AsteroidDash::object_world_column(int object) const {
+    return static_cast<long>(space_grid.get_width()) - 1 + level->spawn_tick[object];
+}
 
+void AsteroidDash::reindex_object(int object, int width) {
+    int &indexed = celestial_store.indexed_width[object];
+    if (indexed == width) return;
+    long column = object_world_column(object);
+    if (indexed > 0) column_index.remove(object, column, indexed);
+    if (width > 0) column_index.insert(object, column, width);
+    indexed = width;
+}
 
-// Print the entire space grid
-void AsteroidDash::print_space_grid() const {
-    for (const auto &row : space_grid) {
-        for (int cell : row) {
-            cout << (cell == 0 ? unoccupiedCellChar : occupiedCellChar);
+void AsteroidDash::mark_rows_dirty(int row, int count) {
+    int first = max(0, row), last = min(row + count, space_grid.get_height());
+    for (int i = first; i < last; ++i) {
+        if (!dirty_rows[i]) {
+            dirty_rows[i] = 1;
+            dirty_row_list.push_back(i);
         }
-        cout << endl;
     }
 }
 
-// Function to update the space grid with player, celestial objects, and any other changes
-void AsteroidDash::update_space_grid() {
-    // Clear the grid (set all cells to 0, representing empty spaces)
-    for (auto &row : space_grid) {
-        fill(row.begin(), row.end(), 0);
-    }
+void AsteroidDash::repaint_dirty_rows() {
+    if (dirty_row_list.empty()) return;
 
-    // Update player position on the grid
-    if (player) {
-        for (int i = 0; i < player->spacecraft_shape.size(); ++i) {
-            for (int j = 0; j < player->spacecraft_shape[i].size(); ++j) {
-                int row = player->position_row + i;
-                int col = player->position_col + j;
-                // Ensure player doesn't go out of bounds
-                if (player->spacecraft_shape[i][j] && row >= 0 && row < space_grid.size() && col >= 0 && col < space_grid[0].size()) {
-                    space_grid[row][col] = 1; // Mark the cell as occupied by the player (assuming '1' represents the player)
-                }
+    for (int row : dirty_row_list) {
+        space_grid.clear_row(OBJECT_PLANE, row);
+    }
+    const CelestialStore &store = celestial_store;
+    for (int object : active_objects) {
+        if (!store.on_grid[object]) continue;
+        const uint64_t *masks = store.masks(object, level->shape_arena);
+        int top = store.grid_row[object];
+        int first = max(0, top), last = min(top + store.grid_rows[object], space_grid.get_height());
+        for (int row = first; row < last; ++row) {
+            if (dirty_rows[row]) {
+                space_grid.stamp(OBJECT_PLANE, row, store.grid_col[object], &masks[row - top], 1);
             }
         }
     }
+    for (int row : dirty_row_list) {
+        dirty_rows[row] = 0;
+    }
+    dirty_row_list.clear();
+}
 
-    // Update celestial objects on the grid
-    CelestialObject *current = celestial_objects_list_head;
-    while (current) {
-        for (int i = 0; i < current->shape.size(); ++i) {
-            for (int j = 0; j < current->shape[i].size(); ++j) {
-                int row = current->starting_row + i;
-                int col = j;  // Assuming celestial objects enter from the rightmost column
-                // Ensure celestial objects don't go out of bounds
-                if (current->shape[i][j] && row >= 0 && row < space_grid.size() && col >= 0 && col < space_grid[0].size()) {
-                    space_grid[row][col] = 2; // Mark the cell as occupied by a celestial object (assuming '2' represents celestial objects)
-                }
-            }
+// Asteroids cost a life, power-ups are collected. Either way the object leaves the grid.
+void AsteroidDash::handle_collision(int object) {
+    celestial_store.destroy(object);
+    ObjectType type = static_cast<ObjectType>(level->object_type[object]);
+    if (type == ASTEROID) {
+        player->lives--;
+        if (player->lives <= 0) {
+            game_over = true;
         }
-        current = current->next_celestial_object;
+    } else if (type == LIFE_UP) {
+        player->lives++;
+    } else if (type == AMMO) {
+        player->current_ammo = player->max_ammo;
     }
 }
 
 // Corresponds to the SHOOT command.
-void AsteroidDash::shoot() {
+bool AsteroidDash::shoot() {
     if (player && player->current_ammo > 0) {
         player->current_ammo--;
 
@@ -253,46 +245,346 @@ void AsteroidDash::shoot() {
         int shot_row = player->position_row;
         int shot_col = player->position_col + (player->spacecraft_shape[0].size() / 2); // Middle column of the player
 
-        // Traverse the path of the shot upward
+        if (shot_col < 0 || shot_col >= space_grid.get_width()) return true;
+
+        // Candidates are the objects registered for the shot's column
+        const vector<int> &candidates = column_index.objects_at(shot_col + static_cast<long>(painted_time));
+        int word = shot_col >> 6;
+        uint64_t shot_bit = 1ULL << (shot_col & 63);
+
+        // Walk the object plane upward to the first occupied cell of the column, then find its owner.
+        // A set cell without an owner is a stale cell of an object damaged this tick; the shot passes it.
+        // Empty tiles are skipped whole.
         for (int row = shot_row - 1; row >= 0; --row) {
-            bool hit_detected = false;
-            CelestialObject *current = celestial_objects_list_head;
-
-            while (current) {
-                // Check if the shot hits this celestial object
-                if (row >= current->starting_row &&
-                    row < current->starting_row + current->shape.size() &&
-                    shot_col < current->shape[0].size()) {
-                    int local_row = row - current->starting_row;
-                    if (current->shape[local_row][shot_col]) {
-                        // Hit detected - mark as damaged or remove the object if necessary
-                        current->shape[local_row][shot_col] = false; // Mark the hit part
-                        hit_detected = true;
-                        break;
+            const uint64_t *tile = space_grid.tile_words(OBJECT_PLANE, row / GRID_TILE_SIZE, word);
+            if (!tile) {
+                row -= row % GRID_TILE_SIZE;
+                continue;
+            }
+            if (!(tile[row % GRID_TILE_SIZE] & shot_bit)) continue;
+
+            for (int object : candidates) {
+                int local_row = row - celestial_store.grid_row[object];
+                int local_col = shot_col - celestial_store.grid_col[object];
+                if (!celestial_store.on_grid[object] || !celestial_store.alive[object] || local_row < 0 ||
+                    local_row >= celestial_store.grid_rows[object] || local_col < 0 || local_col >= 64) {
+                    continue;
+                }
+                if (celestial_store.damage(object, level->shape_arena, local_row, local_col)) {
+                    if (level->object_type[object] == ASTEROID) {
+                        current_score += POINTS_PER_ASTEROID_HIT;
                     }
+                    // An object with no cells left is gone
+                    if (celestial_store.is_empty(object, level->shape_arena)) {
+                        celestial_store.destroy(object);
                     }
-                current = current->next_celestial_object;
+                    return true;
+                }
             }
+        }
+        return true;
+    }
+    return false;
+}
+
+void AsteroidDash::reset() {
+    if (player) {
+        player->position_row = level->player_row;
+        player->position_col = level->player_col;
+        player->current_ammo = player->max_ammo;
+        player->lives = initial_player_lives;
+    }
+    current_score = 0;
+    game_time = 0;
+    painted_time = 0;
+    game_over = false;
+
+    celestial_store.reset(*level);
+    spawn_scheduler.reset();
+    active_objects.clear();
+    column_index.reset(space_grid.get_width() + 2 * 64);
+
+    space_grid.clear();
+    player_on_grid = false;
+    for (int row : dirty_row_list) {
+        dirty_rows[row] = 0;
+    }
+    dirty_row_list.clear();
+}
+
+StepResult AsteroidDash::step(GameAction action) {
+    unsigned long score_before = current_score;
 
-            // Stop checking further if a hit was detected
-            if (hit_detected) {
+    if (!game_over && player) {
+        switch (action) {
+            case ACTION_MOVE_LEFT: {
+                PROFILE_PHASE(PHASE_MOVE);
+                player->move_left();
+                break;
+            }
+            case ACTION_MOVE_RIGHT: {
+                PROFILE_PHASE(PHASE_MOVE);
+                player->move_right(space_grid.get_width());
+                break;
+            }
+            case ACTION_MOVE_UP: {
+                PROFILE_PHASE(PHASE_MOVE);
+                player->move_up();
+                break;
+            }
+            case ACTION_MOVE_DOWN: {
+                PROFILE_PHASE(PHASE_MOVE);
+                player->move_down(space_grid.get_height());
+                break;
+            }
+            case ACTION_SHOOT: {
+                PROFILE_PHASE(PHASE_SHOOT);
+                shoot();
                 break;
             }
+            default:
+                break;
+        }
+
+        // Move the objects and resolve collisions for this tick
+        {
+            PROFILE_PHASE(PHASE_UPDATE);
+            update_space_grid();
+        }
+        if (!game_over) {
+            current_score += POINTS_PER_TICK;
+        }
+        game_time++;
+    }
+
+    StepResult result;
+    result.observation = observe();
+    result.reward = static_cast<long>(current_score - score_before);
+    result.done = game_over;
+    return result;
+}
+
+unsigned long AsteroidDash::fast_forward(unsigned long ticks) {
+    unsigned long played = 0;
+    while (played < ticks && !game_over) {
+        unsigned long skip = idle_horizon(ticks - played);
+        if (skip < 2) {
+            step(ACTION_NOP);
+            ++played;
+            continue;
+        }
+
+        // Same as skip NOP ticks: every object moves skip columns and each tick scores
+        game_time += skip;
+        painted_time = game_time - 1;
+        current_score += skip * POINTS_PER_TICK;
+        played += skip;
+
+        // Only the object plane changed; repaint it at the last skipped tick
+        space_grid.clear_plane(OBJECT_PLANE);
+        CelestialStore &store = celestial_store;
+        for (int object : active_objects) {
+            store.grid_col[object] = object_column(object) + 1;
+            space_grid.stamp(OBJECT_PLANE, store.grid_row[object], store.grid_col[object],
+                             store.masks(object, level->shape_arena), store.grid_rows[object]);
+        }
+    }
+    return played;
+}
+
+unsigned long AsteroidDash::idle_horizon(unsigned long limit) const {
+    // The player has to be drawn where it is, as it is after any step
+    if (game_over || !player || !player_on_grid || player_grid_row != player->position_row ||
+        player_grid_col != player->position_col) {
+        return 0;
+    }
+
+    unsigned long horizon = limit;
+    if (spawn_scheduler.has_pending(*level)) {
+        unsigned long spawn = spawn_scheduler.next_spawn_time(*level);
+        if (spawn <= game_time) return 0;
+        horizon = min(horizon, spawn - game_time);
+    }
+
+    const CelestialStore &store = celestial_store;
+    const vector<uint64_t> &player_masks = player->shape_masks;
+    int player_row = player->position_row, player_col = player->position_col;
+    int player_rows = player_masks.size();
+    for (int object : active_objects) {
+        // The object is drawn at column - k on the k-th tick from now and retired once it is off the left edge
+        long column = object_column(object);
+        long exit = column + level->shape_arena.width(store.shape_id[object]);
+        if (exit <= 0) return 0;
+        horizon = min(horizon, static_cast<unsigned long>(exit));
+        if (!collision_rules) continue;
+
+        // First tick at which one of its rows lands on a player cell in the same grid row
+        const uint64_t *masks = store.masks(object, level->shape_arena);
+        int top = store.grid_row[object];
+        int first = max(top, player_row), last = min(top + store.grid_rows[object], player_row + player_rows);
+        for (int row = first; row < last; ++row) {
+            uint64_t object_mask = masks[row - top], player_mask = player_masks[row - player_row];
+            if (!object_mask || !player_mask) continue;
+            // offset = object column - player column; rows overlap while it is in (-64, 64)
+            for (unsigned long k = 0; k < horizon; ++k) {
+                long offset = column - static_cast<long>(k) - player_col;
+                if (offset <= -64) break;
+                if (offset >= 64) {
+                    k += offset - 64;  // Not within reach yet
+                    continue;
+                }
+                uint64_t shifted = offset >= 0 ? object_mask << offset : object_mask >> -offset;
+                if (shifted & player_mask) {
+                    horizon = k;
+                    break;
+                }
+            }
         }
-    } else {
-        std::cout << "No ammo left!" << std::endl;
+        if (horizon == 0) return 0;
     }
+    return horizon;
+}
 
+Observation AsteroidDash::observe() const {
+    Observation observation;
+    observation.player_row = player ? player->position_row : 0;
+    observation.player_col = player ? player->position_col : 0;
+    observation.ammo = player ? player->current_ammo : 0;
+    observation.lives = player ? player->lives : 0;
+    observation.score = current_score;
+    observation.tick = game_time;
+    observation.game_over = game_over;
+    observation.grid = &space_grid;
+    return observation;
+}
+
+uint64_t AsteroidDash::state_hash() const {
+    uint64_t hash = celestial_store.zobrist_total ^ zobrist_key(ZOBRIST_TICK, 0, game_time);
+    if (player) {
+        hash ^= zobrist_key(ZOBRIST_PLAYER_ROW, 0, player->position_row) ^
+                zobrist_key(ZOBRIST_PLAYER_COL, 0, player->position_col) ^
+                zobrist_key(ZOBRIST_AMMO, 0, player->current_ammo) ^ zobrist_key(ZOBRIST_LIVES, 0, player->lives);
+    }
+    if (game_over) {
+        hash ^= zobrist_key(ZOBRIST_GAME_OVER, 0, 0);
+    }
+    return hash;
+}
+
+void AsteroidDash::snapshot(GameSnapshot &out) const {
+    if (player) {
+        out.player_row = player->position_row;
+        out.player_col = player->position_col;
+        out.ammo = player->current_ammo;
+        out.lives = player->lives;
+    }
+    out.player_on_grid = player_on_grid;
+    out.player_grid_row = player_grid_row;
+    out.player_grid_col = player_grid_col;
+    out.score = current_score;
+    out.tick = game_time;
+    out.painted_time = painted_time;
+    out.game_over = game_over;
+    out.next_spawn = spawn_scheduler.position();
+    out.damage_size = celestial_store.damage_words.size();
+
+    const CelestialStore &store = celestial_store;
+    out.objects.resize(active_objects.size());
+    out.damage.clear();
+    for (size_t i = 0; i < active_objects.size(); ++i) {
+        int object = active_objects[i];
+        ObjectSnapshot &saved = out.objects[i];
+        saved.index = object;
+        saved.shape_id = store.shape_id[object];
+        saved.grid_row = store.grid_row[object];
+        saved.grid_col = store.grid_col[object];
+        saved.grid_rows = store.grid_rows[object];
+        saved.indexed_width = store.indexed_width[object];
+        saved.damage_offset = store.damage_offset[object];
+        saved.alive = store.alive[object];
+        saved.on_grid = store.on_grid[object];
+        saved.zobrist = store.zobrist[object];
+        if (saved.damage_offset >= 0) {
+            const uint64_t *block = &store.damage_words[saved.damage_offset];
+            out.damage.insert(out.damage.end(), block, block + store.damage_block_size(object, level->shape_arena));
+        }
+    }
+}
+
+void AsteroidDash::restore(const GameSnapshot &in) {
+    if (player) {
+        player->position_row = in.player_row;
+        player->position_col = in.player_col;
+        player->current_ammo = in.ammo;
+        player->lives = in.lives;
+    }
+    player_on_grid = in.player_on_grid;
+    player_grid_row = in.player_grid_row;
+    player_grid_col = in.player_grid_col;
+    current_score = in.score;
+    game_time = in.tick;
+    painted_time = in.painted_time;
+    game_over = in.game_over;
+
+    // Objects that appeared after the snapshot go back to their loaded state
+    CelestialStore &store = celestial_store;
+    for (int object = in.next_spawn; object < spawn_scheduler.position(); ++object) {
+        store.reset_object(object, *level);
+    }
+    spawn_scheduler.rewind(in.next_spawn);
+
+    // Blocks appended after the snapshot belong to objects that were undamaged then
+    store.damage_words.resize(in.damage_size);
+    active_objects.resize(in.objects.size());
+    const uint64_t *block = in.damage.data();
+    store.zobrist_total = 0;
+    for (size_t i = 0; i < in.objects.size(); ++i) {
+        const ObjectSnapshot &saved = in.objects[i];
+        int object = saved.index;
+        active_objects[i] = object;
+        store.shape_id[object] = saved.shape_id;
+        store.grid_row[object] = saved.grid_row;
+        store.grid_col[object] = saved.grid_col;
+        store.grid_rows[object] = saved.grid_rows;
+        store.indexed_width[object] = saved.indexed_width;
+        store.damage_offset[object] = saved.damage_offset;
+        store.alive[object] = saved.alive;
+        store.on_grid[object] = saved.on_grid;
+        store.shape_changed[object] = 0;
+        store.zobrist[object] = saved.zobrist;
+        store.zobrist_total ^= saved.zobrist;
+        if (saved.damage_offset >= 0) {
+            int size = store.damage_block_size(object, level->shape_arena);
+            copy(block, block + size, store.damage_words.begin() + saved.damage_offset);
+            block += size;
+        }
+    }
+
+    // Rebuild the shot index and the grid from the restored footprints
+    column_index.clear();
+    space_grid.clear();
+    for (int object : active_objects) {
+        if (store.indexed_width[object] > 0) {
+            column_index.insert(object, object_world_column(object), store.indexed_width[object]);
+        }
+        if (store.on_grid[object]) {
+            space_grid.stamp(OBJECT_PLANE, store.grid_row[object], store.grid_col[object],
+                             store.masks(object, level->shape_arena), store.grid_rows[object]);
+        }
+    }
+    if (player && player_on_grid) {
+        space_grid.stamp(PLAYER_PLANE, player_grid_row, player_grid_col, player->shape_masks.data(),
+                         player->shape_masks.size());
+    }
+    for (int row : dirty_row_list) {
+        dirty_rows[row] = 0;
+    }
+    dirty_row_list.clear();
 }
 
 // Destructor. Remove dynamically allocated member variables here.
 AsteroidDash::~AsteroidDash() {
     delete player;
 
-    CelestialObject *current = celestial_objects_list_head;
-    while (current) {
-        CelestialObject *to_delete = current;
-        current = current->next_celestial_object;
-        delete to_delete;
-    }
+    // The celestial objects belong to the level, which is freed with its last game
 }
@@ -1,20 +1,110 @@
 #ifndef ASTEROIDDASH_H
 #define ASTEROIDDASH_H
 
+#include <memory>
 #include <vector>
 #include <string>
 #include <iostream>
 
 #include "CelestialObject.h"
+#include "CelestialStore.h"
+#include "ColumnIndex.h"
+#include "FrameRenderer.h"
 #include "LeaderboardEntry.h"
 #include "Leaderboard.h"
+#include "LevelData.h"
 #include "Player.h"
+#include "ShapeArena.h"
+#include "SpaceGrid.h"
+#include "SpawnScheduler.h"
+#include "Zobrist.h"
 
 #define occupiedCellChar "██"
 #define unoccupiedCellChar "▒▒"
 
 using namespace std;
 
+// Verbosity of the diagnostic messages printed while loading and playing
+enum LogLevel {
+    LOG_OFF = 0,
+    LOG_INFO = 1,
+    LOG_DEBUG = 2
+};
+
+// Moves a player can make in one game tick
+enum GameAction {
+    ACTION_NOP = 0,
+    ACTION_MOVE_LEFT = 1,
+    ACTION_MOVE_RIGHT = 2,
+    ACTION_MOVE_UP = 3,
+    ACTION_MOVE_DOWN = 4,
+    ACTION_SHOOT = 5,
+    ACTION_COUNT = 6
+};
+
+// Scoring rule. The original game keeps current_score for the leaderboard but never adds to it, so
+// these values are this engine's choice, and they are what step() rewards and the Autopilot
+// maximizes. A survived tick is worth 1, so staying alive always pays. An asteroid cell shot away is
+// worth 10, so a hit outweighs the few ticks spent lining it up. Power-ups score nothing, since they
+// are collected rather than shot. Scores recorded under other values do not compare with these.
+#define POINTS_PER_TICK 1
+#define POINTS_PER_ASTEROID_HIT 10
+
+// What an agent sees of the game after a tick
+struct Observation {
+    int player_row;
+    int player_col;
+    int ammo;
+    int lives;
+    unsigned long score;
+    unsigned long tick;
+    bool game_over;
+    const SpaceGrid *grid;  // Grid as painted at the end of the tick
+};
+
+// Result of AsteroidDash::step
+struct StepResult {
+    Observation observation;
+    long reward;  // Score gained during the tick
+    bool done;    // True once the game is over
+};
+
+// State of one celestial object in a GameSnapshot
+struct ObjectSnapshot {
+    int index;  // Store index
+    int shape_id;
+    int grid_row;
+    int grid_col;
+    int grid_rows;
+    int indexed_width;
+    int damage_offset;
+    uint8_t alive;
+    uint8_t on_grid;
+    uint64_t zobrist;
+};
+
+// Everything that changes while playing, taken between two ticks by AsteroidDash::snapshot.
+// Only objects that are on their way across the grid are stored: those that have not appeared yet
+// are still in their loaded state and those that left never come back. A snapshot that is reused
+// keeps its buffers, so taking and restoring one does not allocate once they have grown.
+struct GameSnapshot {
+    int player_row = 0;
+    int player_col = 0;
+    int ammo = 0;
+    int lives = 0;
+    bool player_on_grid = false;
+    int player_grid_row = 0;
+    int player_grid_col = 0;
+    unsigned long score = 0;
+    unsigned long tick = 0;
+    unsigned long painted_time = 0;
+    bool game_over = false;
+    int next_spawn = 0;       // SpawnScheduler position
+    size_t damage_size = 0;   // Size of CelestialStore::damage_words
+    vector<ObjectSnapshot> objects;  // The active objects, in order
+    vector<uint64_t> damage;         // Damage blocks of the damaged active objects, back to back
+};
+
 // Class that encapsulates the game play internals
 class AsteroidDash {
 public:
@@ -23,18 +113,44 @@ public:
     AsteroidDash(const string &space_grid_file_name, const string &celestial_objects_file_name,
                  const string &leaderboard_file_name, const string &player_file_name, const string &player_name);
 
+    // Constructor to play an already loaded level, which may be shared with other games.
+    // Reads no file, including the leaderboard.
+    AsteroidDash(shared_ptr<LevelData> level, const string &player_name);
+
     // Destructor. Remove dynamically allocated member variables here
     virtual ~AsteroidDash();
 
-    // 2D space_grid
-    vector<vector<int> > space_grid;
+    // Loaded, read-only description of the level
+    shared_ptr<LevelData> level;
+
+    // 2D space_grid, bit-packed (see SpaceGrid)
+    SpaceGrid space_grid;
 
     // Pointer to track the player instance
     Player *player = nullptr;
 
-    // A reference to the head of the celestial objects linked list
+    // A reference to the head of the celestial objects linked list, owned by the level
     CelestialObject *celestial_objects_list_head = nullptr;
 
+    // Diagnostic output level for every game; off unless a caller raises it
+    static LogLevel log_level;
+
+    // Per-object state while playing, one column per field
+    CelestialStore celestial_store;
+
+    // Objects waiting for their time of appearance
+    SpawnScheduler spawn_scheduler;
+
+    // Store indices of the objects that have appeared and not yet left the grid, in ascending order;
+    // the only ones the tick loop looks at
+    vector<int> active_objects;
+
+    // Active objects by the world columns they cover, so a shot finds its target with one lookup
+    ColumnIndex column_index;
+
+    // game_time at the last update_space_grid, i.e. the tick the grid currently shows
+    unsigned long painted_time = 0;
+
     // Current score of the game
     unsigned long current_score = 0;
 
@@ -50,6 +166,46 @@ public:
     // True if the game is over
     bool game_over = false;
 
+    // Off by default: celestial objects are only painted, even over the player, as in the original game.
+    // When set, an object that touches the player is resolved by handle_collision and leaves the grid.
+    bool collision_rules = false;
+
+    // Player lives at load time, restored by reset(); the start position is in the level
+    int initial_player_lives = 0;
+
+    // Headless game API: puts the level back to tick 0 without reading any file
+    void reset();
+
+    // Headless game API: plays one tick with the given action. No console output.
+    StepResult step(GameAction action);
+
+    // Plays up to ticks NOP ticks and returns how many were played (fewer only if the game ends).
+    // Stretches in which no object appears, leaves or hits the player are jumped over in one go;
+    // the resulting state is the same as calling step(ACTION_NOP) that many times.
+    unsigned long fast_forward(unsigned long ticks);
+
+    // Number of NOP ticks from game_time on, at most limit, in which nothing happens but objects moving
+    unsigned long idle_horizon(unsigned long limit) const;
+
+    // Current state as seen by an agent
+    Observation observe() const;
+
+    // Zobrist hash of the state between two ticks: tick, player position, ammo, lives, game over and
+    // the damage and destruction of every object in play. Objects that have not appeared are implied
+    // by the tick, and the score is left out, so equal positions reached with different scores hash
+    // the same. O(1): the object part is kept up to date by CelestialStore as the game is played.
+    uint64_t state_hash() const;
+
+    // Copies the state of the game into out, for restore() to go back to it later
+    void snapshot(GameSnapshot &out) const;
+
+    // Puts the game back in a state taken by snapshot() on this game or on another game of the same
+    // level. The grid is rebuilt from the restored objects rather than stored in the snapshot.
+    void restore(const GameSnapshot &in);
+
+    // Draws print_space_grid frames; set its mode to RENDER_LIVE to redraw only changed cells
+    mutable FrameRenderer frame_renderer{occupiedCellChar, unoccupiedCellChar};
+
     // Function to print the space_grid
     void print_space_grid() const;
 
@@ -63,10 +219,45 @@ public:
     // Reads the input file and calls the read_celestial_object() function for each celestial_object;
     void read_celestial_objects(const string &input_file);
 
-    // Updates the grid based on player and celestial object states
+    // Size the grid, create the player and set up the object state from the loaded level
+    void init_grid();
+    void init_player(const string &player_name);
+    void init_objects();
+
+    // Updates the grid based on player and celestial object states at the current game_time.
+    // Celestial objects appear at the rightmost column at their time_of_appearance and move one column left per tick.
     void update_space_grid();
 
-    void shoot();
+    // Column of an active object's left edge at the current game_time
+    int object_column(int object) const;
+
+    // Column an object's left edge would have at tick 0; constant while it moves
+    long object_world_column(int object) const;
+
+    // Registers the object in column_index with its current width, or removes it when width is 0
+    void reindex_object(int object, int width);
+
+    // Applies the effect of a celestial object colliding with the player (only with collision_rules):
+    // an asteroid costs a life and ends the game at 0, LIFE_UP adds a life, AMMO refills the ammo
+    void handle_collision(int object);
+
+    // Player footprint currently painted on the space grid
+    bool player_on_grid = false;
+    int player_grid_row = 0;
+    int player_grid_col = 0;
+
+    // Rows of the object plane that must be repainted before the next read of the grid
+    vector<char> dirty_rows;
+    vector<int> dirty_row_list;
+
+    // Marks rows [row, row + count) of the object plane for repainting
+    void mark_rows_dirty(int row, int count);
+
+    // Clears the dirty rows of the object plane and repaints the objects that cover them
+    void repaint_dirty_rows();
+
+    // Corresponds to the SHOOT command. Returns false if the player had no ammo left.
+    bool shoot();
 };
 
 
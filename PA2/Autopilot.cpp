@@ -0,0 +1,166 @@
+#include "Autopilot.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+// Mixes the seed, the hash of the state after the tried action and the rollout's number among that
+// action's rollouts into the seed of the rollout's random moves, which is also its table key
+static uint64_t rollout_key(uint64_t seed, uint64_t state_hash, uint64_t rollout) {
+    return zobrist_mix(seed ^ (state_hash * 0x9E3779B97F4A7C15ULL) ^ (rollout * 0xC2B2AE3D27D4EB4FULL));
+}
+
+Autopilot::Autopilot(shared_ptr<LevelData> level, int threads, int rollouts_per_action, int horizon, uint64_t seed)
+    : level(level), threads(threads), rollouts_per_action(max(1, rollouts_per_action)), horizon(max(1, horizon)),
+      seed(seed) {
+    if (this->threads <= 0) {
+        this->threads = max(1u, thread::hardware_concurrency());
+    }
+    for (int w = 0; w < this->threads; ++w) {
+        games.emplace_back(new AsteroidDash(level, "autopilot"));
+    }
+    // The calling thread is worker 0
+    for (int w = 1; w < this->threads; ++w) {
+        pool.emplace_back(&Autopilot::worker_loop, this, w);
+    }
+}
+
+Autopilot::~Autopilot() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (thread &t : pool) {
+        t.join();
+    }
+}
+
+void Autopilot::worker_loop(int w) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            work_ready.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        run_rollouts(w);
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            if (--busy_workers == 0) work_done.notify_one();
+        }
+    }
+}
+
+void Autopilot::run_rollouts(int w) {
+    AsteroidDash &game = *games[w];
+    mt19937_64 rng;
+    int total = static_cast<int>(values.size());
+    unsigned long long hits = 0;
+
+    while (true) {
+        int k = next_rollout.fetch_add(1, memory_order_relaxed);
+        if (k >= total) break;
+
+        game.restore(root);
+
+        // The action being tried
+        bool done = game.step(static_cast<GameAction>(k / rollouts_per_action)).done;
+        int lives = game.player ? game.player->lives : 0;
+        long value = static_cast<long>(game.current_score - root.score) -
+                     AUTOPILOT_LIFE_PENALTY * max(0, root.lives - lives);
+        if (done || horizon == 1) {
+            values[k] = value;
+            continue;
+        }
+
+        // Then random moves, unless a rollout from the same state already played them
+        uint64_t key = rollout_key(seed ^ game.collision_rules, game.state_hash(), k % rollouts_per_action);
+        // A rollout value is only the same value for the same number of random ticks
+        TranspositionEntry entry;
+        if (table.probe(key, horizon - 1, entry) && entry.depth == horizon - 1) {
+            values[k] = value + entry.value;
+            ++hits;
+            continue;
+        }
+        unsigned long score = game.current_score;
+        rng.seed(key);
+        for (int tick = 1; tick < horizon && !done; ++tick) {
+            done = game.step(static_cast<GameAction>(rng() % ACTION_COUNT)).done;
+        }
+        int lives_lost = lives - (game.player ? game.player->lives : 0);
+        long rest = static_cast<long>(game.current_score - score) - AUTOPILOT_LIFE_PENALTY * max(0, lives_lost);
+        table.store(key, rest, horizon - 1);
+        values[k] = value + rest;
+    }
+    table_hits.fetch_add(hits, memory_order_relaxed);
+}
+
+GameAction Autopilot::decide(const AsteroidDash &game) {
+    if (game.level != level) {
+        throw invalid_argument("Autopilot asked to play a game of another level");
+    }
+    if (game.game_over) return ACTION_NOP;
+
+    game.snapshot(root);
+    for (unique_ptr<AsteroidDash> &worker_game : games) {
+        worker_game->collision_rules = game.collision_rules;
+    }
+    values.assign(static_cast<size_t>(ACTION_COUNT) * rollouts_per_action, 0);
+    next_rollout.store(0, memory_order_relaxed);
+
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        busy_workers = threads - 1;
+        ++generation;
+    }
+    work_ready.notify_all();
+    run_rollouts(0);
+    {
+        unique_lock<mutex> lock(pool_mutex);
+        work_done.wait(lock, [&] { return busy_workers == 0; });
+    }
+
+    // Highest total value wins; ties go to the lowest action, so NOP before any move
+    GameAction best = ACTION_NOP;
+    long best_value = 0;
+    for (int action = 0; action < ACTION_COUNT; ++action) {
+        long value = 0;
+        for (int i = 0; i < rollouts_per_action; ++i) {
+            value += values[action * rollouts_per_action + i];
+        }
+        if (action == 0 || value > best_value) {
+            best = static_cast<GameAction>(action);
+            best_value = value;
+        }
+    }
+    return best;
+}
+
+AutopilotSummary Autopilot::play(AsteroidDash &game, unsigned long ticks, vector<GameAction> *actions) {
+    auto start = chrono::steady_clock::now();
+    AutopilotSummary summary;
+    unsigned long long hits_before = table_hits.load(memory_order_relaxed);
+
+    for (unsigned long tick = 0; tick < ticks && !game.game_over; ++tick) {
+        GameAction action = decide(game);
+        ++summary.decisions;
+        summary.rollouts += values.size();
+        if (actions) actions->push_back(action);
+        game.step(action);
+    }
+    summary.table_hits = table_hits.load(memory_order_relaxed) - hits_before;
+    summary.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        double seconds = summary.elapsed_seconds > 0 ? summary.elapsed_seconds : 1;
+        cout << "Autopilot made " << summary.decisions << " decisions (" << summary.rollouts << " rollouts of "
+             << horizon << " ticks, " << summary.table_hits << " from the transposition table) on " << threads
+             << " threads in " << summary.elapsed_seconds * 1000 << " ms, "
+             << summary.decisions / seconds << " decisions/s, " << summary.rollouts / seconds << " rollouts/s"
+             << endl;
+    }
+    return summary;
+}
@@ -0,0 +1,98 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AsteroidDash.h"
+#include "LevelData.h"
+#include "TranspositionTable.h"
+
+using namespace std;
+
+// Default rollouts played for each candidate action of a decision, and their length in ticks
+#define AUTOPILOT_ROLLOUTS_PER_ACTION 16
+#define AUTOPILOT_HORIZON 32
+
+// Value of a rollout: score gained, minus this much for every life lost on the way
+#define AUTOPILOT_LIFE_PENALTY 1000
+
+// Totals of an Autopilot::play
+struct AutopilotSummary {
+    unsigned long decisions = 0;
+    unsigned long long rollouts = 0;
+    unsigned long long table_hits = 0;  // Rollouts whose random part came from the transposition table
+    double elapsed_seconds = 0;
+};
+
+// Picks each move of a game by Monte Carlo rollouts: every action is played from the current state,
+// followed by random moves for the rest of the horizon, and the action with the best average value
+// is chosen. Rollouts run on a pool of threads that lives as long as the autopilot. Each worker
+// keeps its own AsteroidDash on the level and restores it from a snapshot of the game being played,
+// so no game state is allocated per rollout. The random moves of a rollout are seeded from the state
+// its action leads to and the rollout's number among that action's rollouts, so their value only
+// depends on that state: it is kept in a TranspositionTable shared by the workers and by every game
+// the autopilot plays on the level, and actions that lead to the same state (a move into the edge of
+// the grid and a NOP) share their rollouts. Values never depend on the number of threads, so a level
+// and seed always give the same game.
+class Autopilot {
+public:
+    // threads 0 means hardware_concurrency()
+    Autopilot(shared_ptr<LevelData> level, int threads = 0, int rollouts_per_action = AUTOPILOT_ROLLOUTS_PER_ACTION,
+              int horizon = AUTOPILOT_HORIZON, uint64_t seed = 1);
+
+    // Stops the worker threads
+    ~Autopilot();
+
+    Autopilot(const Autopilot &) = delete;
+    Autopilot &operator=(const Autopilot &) = delete;
+
+    // Best action for the game's current state; game must be playing the autopilot's level
+    GameAction decide(const AsteroidDash &game);
+
+    // Plays up to ticks ticks of the game, or until it is over, appending each action to actions if given
+    AutopilotSummary play(AsteroidDash &game, unsigned long ticks, vector<GameAction> *actions = nullptr);
+
+    int get_threads() const { return threads; }
+
+private:
+    // Plays the rollouts left in the current decision on worker w's game
+    void run_rollouts(int w);
+
+    // Body of the pool threads
+    void worker_loop(int w);
+
+    shared_ptr<LevelData> level;
+    int threads;
+    int rollouts_per_action;
+    int horizon;
+    uint64_t seed;
+
+    // One game per worker, restored from root before every rollout
+    vector<unique_ptr<AsteroidDash>> games;
+
+    // The current decision: its state and the value of each rollout
+    GameSnapshot root;
+    vector<long> values;  // Rollout k tries action k / rollouts_per_action
+    atomic<int> next_rollout{0};
+
+    // Value of the random part of a rollout, by rollout_key
+    TranspositionTable table;
+    atomic<unsigned long long> table_hits{0};
+
+    // Pool: workers wake when generation changes and the last one to finish signals done
+    vector<thread> pool;
+    mutex pool_mutex;
+    condition_variable work_ready;
+    condition_variable work_done;
+    uint64_t generation = 0;
+    int busy_workers = 0;
+    bool stopping = false;
+};
+
+#endif // AUTOPILOT_H
@@ -0,0 +1,181 @@
+#include "BatchRunner.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+int BatchRunner::add_level(const string &space_grid_file_name, const string &celestial_objects_file_name,
+                           const string &player_file_name) {
+    levels.push_back(LevelData::load(space_grid_file_name, celestial_objects_file_name, player_file_name));
+    return levels.size() - 1;
+}
+
+int BatchRunner::add_script(const string &commands_file) {
+    scripts.emplace_back();
+    if (!scripts.back().read(commands_file)) {
+        scripts.pop_back();
+        return -1;
+    }
+    return scripts.size() - 1;
+}
+
+bool BatchRunner::add_job(int level, int script, const string &player_name) {
+    if (level < 0 || level >= static_cast<int>(levels.size()) || script < 0 ||
+        script >= static_cast<int>(scripts.size())) {
+        cerr << "Error: Batch job for " << player_name << " has no such level or script." << endl;
+        return false;
+    }
+    // Same check as GameController::play
+    if (scripts[script].level_hash != 0 && scripts[script].level_hash != levels[level]->hash()) {
+        cerr << "Error: Batch job for " << player_name << " uses a replay recorded on a different level." << endl;
+        return false;
+    }
+    jobs.push_back(BatchJob{level, script, player_name});
+    return true;
+}
+
+// Jobs [next, end) not yet claimed by any worker. Padded to a cache line so workers do not
+// slow each other down by claiming from neighbouring ranges.
+struct alignas(64) WorkRange {
+    atomic<size_t> next{0};
+    size_t end = 0;
+};
+
+BatchSummary BatchRunner::run(int threads) {
+    auto start = chrono::steady_clock::now();
+
+    if (threads <= 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    threads = static_cast<int>(max<size_t>(1, min<size_t>(threads, jobs.size())));
+    results.assign(jobs.size(), BatchResult());
+
+    // Contiguous ranges keep a worker on few levels, so it reuses the same few games
+    unique_ptr<WorkRange[]> ranges(new WorkRange[threads]);
+    for (int w = 0; w < threads; ++w) {
+        ranges[w].next = jobs.size() * w / threads;
+        ranges[w].end = jobs.size() * (w + 1) / threads;
+    }
+
+    auto worker = [&](int w) {
+        vector<unique_ptr<AsteroidDash>> games(levels.size());
+
+        // Own range first, then steal from the others in turn
+        for (int k = 0; k < threads; ++k) {
+            WorkRange &range = ranges[(w + k) % threads];
+            while (true) {
+                size_t job = range.next.fetch_add(1, memory_order_relaxed);
+                if (job >= range.end) break;
+
+                unique_ptr<AsteroidDash> &game = games[jobs[job].level];
+                if (!game) {
+                    game.reset(new AsteroidDash(levels[jobs[job].level], jobs[job].player_name));
+                }
+                play(*game, job);
+            }
+        }
+    };
+
+    vector<thread> pool;
+    for (int w = 1; w < threads; ++w) {
+        pool.emplace_back(worker, w);
+    }
+    worker(0);
+    for (thread &t : pool) {
+        t.join();
+    }
+
+    BatchSummary summary;
+    summary.games = jobs.size();
+    summary.threads = threads;
+    for (const BatchResult &result : results) {
+        summary.total_score += result.score;
+        summary.total_ticks += result.ticks;
+        summary.games_over += result.game_over;
+    }
+    summary.elapsed_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        cout << "Played " << summary.games << " games (" << summary.total_ticks << " ticks) on " << threads
+             << " threads in " << summary.elapsed_seconds * 1000 << " ms, "
+             << (summary.elapsed_seconds > 0 ? summary.total_ticks / summary.elapsed_seconds : 0) << " ticks/s"
+             << endl;
+    }
+    return summary;
+}
+
+SnapshotSummary BatchRunner::measure_snapshots(int level, int script, int repeats) {
+    SnapshotSummary summary;
+    if (level < 0 || level >= static_cast<int>(levels.size()) || script < 0 ||
+        script >= static_cast<int>(scripts.size())) {
+        return summary;
+    }
+
+    AsteroidDash game(levels[level], "snapshots");
+    game.collision_rules = collision_rules;
+    GameSnapshot snapshot;
+    chrono::steady_clock::duration elapsed{0};
+
+    for (GameAction action : scripts[script].actions) {
+        if (game.game_over) break;
+
+        size_t object_capacity = snapshot.objects.capacity();
+        size_t damage_capacity = snapshot.damage.capacity();
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            game.snapshot(snapshot);
+            game.restore(snapshot);
+        }
+        elapsed += chrono::steady_clock::now() - start;
+        summary.buffer_growths += (snapshot.objects.capacity() != object_capacity) +
+                                  (snapshot.damage.capacity() != damage_capacity);
+        summary.snapshots += repeats;
+        summary.objects += static_cast<unsigned long long>(snapshot.objects.size()) * repeats;
+
+        game.step(action);
+    }
+    summary.elapsed_seconds = chrono::duration<double>(elapsed).count();
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        double seconds = summary.elapsed_seconds > 0 ? summary.elapsed_seconds : 1;
+        cout << "Took and restored " << summary.snapshots << " snapshots of "
+             << (summary.snapshots ? static_cast<double>(summary.objects) / summary.snapshots : 0)
+             << " active objects on average in " << summary.elapsed_seconds * 1000 << " ms, "
+             << summary.snapshots / seconds << " snapshots/s; the snapshot buffers grew "
+             << summary.buffer_growths << " times" << endl;
+    }
+    return summary;
+}
+
+void BatchRunner::play(AsteroidDash &game, size_t job) {
+    game.reset();
+    game.collision_rules = collision_rules;
+    if (game.player) {
+        game.player->player_name = jobs[job].player_name;
+    }
+
+    const vector<GameAction> &actions = scripts[jobs[job].script].actions;
+    for (size_t tick = 0; tick < actions.size() && !game.game_over;) {
+        if (actions[tick] != ACTION_NOP) {
+            game.step(actions[tick++]);
+            continue;
+        }
+        // Runs of NOPs are fast-forwarded
+        size_t run_end = tick + 1;
+        while (run_end < actions.size() && actions[run_end] == ACTION_NOP) ++run_end;
+        game.fast_forward(run_end - tick);
+        tick = run_end;
+    }
+
+    BatchResult &result = results[job];
+    result.score = game.current_score;
+    result.ticks = game.game_time;
+    result.lives = game.player ? game.player->lives : 0;
+    result.game_over = game.game_over;
+
+    if (leaderboard) {
+        leaderboard->submit(result.score, time(nullptr), jobs[job].player_name);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AsteroidDash.h"
+#include "CommandScript.h"
+#include "ConcurrentLeaderboard.h"
+#include "LevelData.h"
+
+using namespace std;
+
+// One game of a batch: which level, which commands and who plays
+struct BatchJob {
+    int level;
+    int script;
+    string player_name;
+};
+
+// Final state of one game of a batch
+struct BatchResult {
+    unsigned long score = 0;
+    unsigned long ticks = 0;
+    int lives = 0;
+    bool game_over = false;
+};
+
+// Totals over a whole batch
+struct BatchSummary {
+    size_t games = 0;
+    unsigned long long total_score = 0;
+    unsigned long long total_ticks = 0;
+    size_t games_over = 0;
+    int threads = 0;
+    double elapsed_seconds = 0;
+};
+
+// Totals of a BatchRunner::measure_snapshots
+struct SnapshotSummary {
+    unsigned long long snapshots = 0;  // Snapshot and restore pairs
+    unsigned long long objects = 0;    // Active objects stored, over all snapshots
+    size_t buffer_growths = 0;         // Times the reused snapshot's buffers had to grow
+    double elapsed_seconds = 0;        // Spent in snapshot and restore only
+};
+
+// Plays many independent games headlessly on a pool of threads.
+// Every level file and commands file is read once; the loaded levels are shared read-only by all
+// games, and each worker keeps one AsteroidDash per level that it reset()s between its games.
+// Jobs are split in contiguous ranges, one per worker; a worker that runs out of jobs steals from
+// the ranges of the others.
+class BatchRunner {
+public:
+    // Loads a level; returns its index for add_job
+    int add_level(const string &space_grid_file_name, const string &celestial_objects_file_name,
+                  const string &player_file_name);
+
+    // Reads a text commands file or binary replay; returns its index for add_job, or -1 if it
+    // could not be read
+    int add_script(const string &commands_file);
+
+    // Queues a game. Returns false, and queues nothing, for an unknown level or script or for a
+    // replay recorded on another level.
+    bool add_job(int level, int script, const string &player_name);
+
+    // Plays every queued game, using hardware_concurrency() threads when threads is 0.
+    // results[i] is filled for jobs[i].
+    BatchSummary run(int threads = 0);
+
+    // Times AsteroidDash::snapshot and restore on one thread: plays a script on a level and, before
+    // every tick, takes a snapshot into one reused GameSnapshot and restores it, repeats times
+    SnapshotSummary measure_snapshots(int level, int script, int repeats = 16);
+
+    vector<shared_ptr<LevelData>> levels;
+    vector<CommandScript> scripts;
+    vector<BatchJob> jobs;
+    vector<BatchResult> results;
+
+    // If set, every finished game submits its score here
+    ConcurrentLeaderboard *leaderboard = nullptr;
+
+    // Plays every game with AsteroidDash::collision_rules
+    bool collision_rules = false;
+
+private:
+    // Plays jobs[job] on game, which must belong to the job's level
+    void play(AsteroidDash &game, size_t job);
+};
+
+#endif // BATCHRUNNER_H
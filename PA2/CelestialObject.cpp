@@ -1,44 +1,73 @@
 #include "CelestialObject.h"
+#include "CelestialStore.h"
+#include "SpaceGrid.h"
+#include <algorithm>
+
+// Turns height row masks width cells wide into a 2D boolean vector
+static vector<vector<bool>> to_cells(const uint64_t *rows, int height, int width) {
+    vector<vector<bool>> cells(height, vector<bool>(width));
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            cells[i][j] = rows[i] >> j & 1;
+        }
+    }
+    return cells;
+}
 
 // Constructor to initialize CelestialObject with essential properties
-CelestialObject::CelestialObject(const vector<vector<bool>> &shape, ObjectType type, int start_row,
+CelestialObject::CelestialObject(int shape_id, const ShapeArena &shapes, ObjectType type, int start_row,
                                  int time_of_appearance)
-        : shape(shape), object_type(type), starting_row(start_row), time_of_appearance(time_of_appearance) {
-    
-    // Initial setup can be done here if needed
+        : shape_id(shape_id), shapes(&shapes), object_type(type), starting_row(start_row),
+          time_of_appearance(time_of_appearance) {
+}
+
+CelestialObject::CelestialObject(const vector<vector<bool>> &shape, ObjectType type, int start_row,
+                                 int time_of_appearance, ShapeArena &shapes)
+        : shapes(&shapes), object_type(type), starting_row(start_row), time_of_appearance(time_of_appearance) {
+    size_t width = 0;
+    for (const vector<bool> &row : shape) {
+        width = max(width, row.size());
+    }
+    shape_id = shapes.add(SpaceGrid::to_row_masks(shape), width);
 }
 
 // Copy constructor for CelestialObject
 CelestialObject::CelestialObject(const CelestialObject *other)
-        : shape(other->shape),  // Copy the 2D vector shape
+        : shape_id(other->shape_id),  // Share the same shape and rotations
+          shapes(other->shapes),
           object_type(other->object_type),  // Copy the object type
           starting_row(other->starting_row),  // Copy the starting row
           time_of_appearance(other->time_of_appearance)  // Copy the time of appearance
 {
-    // Additional copying logic can be added here if needed
 }
 
-// Function to delete rotations of a given celestial object. It should free the dynamically allocated
-// memory for each rotation.
-void CelestialObject::delete_rotations(CelestialObject *target) {
-    // Check if the target has rotations
-    if (target->right_rotation) {
-        // Break the circular links first before deleting
-        target->right_rotation->left_rotation = target->left_rotation; // The left rotation of right_rotation should point to the left rotation of target
-        target->left_rotation->right_rotation = target->right_rotation; // The right rotation of left_rotation should point to the right rotation of target
+void *CelestialObject::operator new(size_t size, NodeArena<CelestialObject> &arena) {
+    // Classes derived from this one are larger than an arena node
+    return size == sizeof(CelestialObject) ? arena.allocate() : ::operator new(size);
+}
 
-        // Now we can safely delete the right rotation
-        delete target->right_rotation;
-        target->right_rotation = nullptr; // Set to nullptr after deletion to avoid dangling pointer
-    }
+vector<vector<bool>> CelestialObject::shape() const {
+    return to_cells(shapes->masks(shape_id), shapes->height(shape_id), shapes->width(shape_id));
+}
 
-    if (target->left_rotation) {
-        // Break the circular links first before deleting
-        target->right_rotation->left_rotation = target->left_rotation; // The left rotation of right_rotation should point to the left rotation of target
-        target->left_rotation->right_rotation = target->right_rotation; // The right rotation of left_rotation should point to the right rotation of target
+vector<vector<bool>> CelestialObject::shape(const CelestialStore &store) const {
+    int id = store.shape_id[store_index];
+    return to_cells(store.masks(store_index, *shapes), shapes->height(id), shapes->width(id));
+}
 
-        // Now we can safely delete the left rotation
-        delete target->left_rotation;
-        target->left_rotation = nullptr; // Set to nullptr after deletion to avoid dangling pointer
-    }
+CelestialObject CelestialObject::right_rotation() const {
+    CelestialObject rotated(this);
+    rotated.shape_id = ShapeArena::rotate_right(shape_id);
+    rotated.store_index = store_index;
+    return rotated;
+}
+
+CelestialObject CelestialObject::left_rotation() const {
+    CelestialObject rotated(this);
+    rotated.shape_id = ShapeArena::rotate_left(shape_id);
+    rotated.store_index = store_index;
+    return rotated;
+}
+
+void CelestialObject::delete_rotations(CelestialObject *) {
 }
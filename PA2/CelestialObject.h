@@ -1,10 +1,16 @@
 #ifndef CELESTIALOBJECT_H
 #define CELESTIALOBJECT_H
 
+#include <cstddef>
 #include <vector>
 
+#include "NodeArena.h"
+#include "ShapeArena.h"
+
 using namespace std;
 
+class CelestialStore;
+
 // Enum to represent the type of the object (asteroid, life-up, or ammo)
 enum ObjectType {
     ASTEROID = 0,
@@ -15,20 +21,48 @@ enum ObjectType {
 class CelestialObject {
 public:
 
-    // Constructor to initialize CelestialObject with essential properties
-    CelestialObject(const vector<vector<bool>> &shape, ObjectType type, int start_row, int time_of_appearance);
+    // Constructor to initialize CelestialObject with essential properties; shape_id is the object's
+    // unrotated shape in shapes, the level's ShapeArena
+    CelestialObject(int shape_id, const ShapeArena &shapes, ObjectType type, int start_row, int time_of_appearance);
+
+    // Constructor taking the shape as a 2D boolean vector; the shape is registered in shapes, which
+    // keeps the only copy of the cells
+    CelestialObject(const vector<vector<bool>> &shape, ObjectType type, int start_row, int time_of_appearance,
+                    ShapeArena &shapes);
 
     // Copy constructor for CelestialObject
     CelestialObject(const CelestialObject *other);
 
-    // Shape of the object represented as a 2D boolean vector
-    vector<vector<bool>> shape;
+    // A level's nodes are placed in its NodeArena, new (level.node_arena) CelestialObject(...), and
+    // freed with it; they must never be deleted. A plain new allocates from the heap as usual.
+    static void *operator new(size_t size, NodeArena<CelestialObject> &arena);
+    static void *operator new(size_t size) { return ::operator new(size); }
+    static void operator delete(void *pointer) { ::operator delete(pointer); }
 
-    // Pointer to the object's clockwise neighbor (its right rotation)
-    CelestialObject *right_rotation = nullptr;
+    // Shape of the object as a 2D boolean vector, read from the ShapeArena
+    vector<vector<bool>> shape() const;
 
-    // Pointer to the object's clockwise neighbor (its left rotation)
-    CelestialObject *left_rotation = nullptr;
+    // Shape of the object as it is in the game playing from store, with the cells shot away so far removed
+    vector<vector<bool>> shape(const CelestialStore &store) const;
+
+    // The object turned 90 degrees clockwise / counter-clockwise. The rotations are precomputed in the
+    // ShapeArena, so these are views that only change shape_id; they are not part of the list.
+    CelestialObject right_rotation() const;
+    CelestialObject left_rotation() const;
+
+    // Rotations are ShapeArena entries shared with every identical object and freed with the level,
+    // so there is nothing to free for one object; kept for callers of the linked-rotation API.
+    static void delete_rotations(CelestialObject *target);
+
+    // Shape in the level's ShapeArena, which holds the only copy of the cells: the unrotated shape for
+    // a loaded object, a rotation of it for a view from right_rotation / left_rotation
+    int shape_id;
+
+    // ShapeArena the shape_id belongs to
+    const ShapeArena *shapes;
+
+    // Position of this object in the LevelData schedule and in each game's CelestialStore, which holds its state while playing
+    int store_index = -1;
 
     // Pointer to the next celestial object in the list
     CelestialObject *next_celestial_object = nullptr;
@@ -41,10 +75,6 @@ public:
 
     // The step in the game after which the object will appear on the grid
     int time_of_appearance;
-
-    // Function to delete rotations of a given celestial object. It should free the dynamically allocated
-    // space for each rotation.
-    static void delete_rotations(CelestialObject *target);
 };
 
 #endif // CELESTIALOBJECT_H
@@ -0,0 +1,63 @@
+#include "CelestialStore.h"
+#include <algorithm>
+
+void CelestialStore::reset(const LevelData &level) {
+    size_t count = level.initial_shape_id.size();
+    shape_id = level.initial_shape_id;
+    alive.assign(count, 1);
+    shape_changed.assign(count, 0);
+    on_grid.assign(count, 0);
+    grid_row.assign(count, 0);
+    grid_col.assign(count, 0);
+    grid_rows.assign(count, 0);
+    indexed_width.assign(count, 0);
+    damage_offset.assign(count, -1);
+    damage_words.clear();
+    zobrist.assign(count, 0);
+    zobrist_total = 0;
+}
+
+void CelestialStore::reset_object(int index, const LevelData &level) {
+    shape_id[index] = level.initial_shape_id[index];
+    alive[index] = 1;
+    shape_changed[index] = 0;
+    on_grid[index] = 0;
+    grid_row[index] = 0;
+    grid_col[index] = 0;
+    grid_rows[index] = 0;
+    indexed_width[index] = 0;
+    damage_offset[index] = -1;
+    zobrist[index] = 0;
+}
+
+bool CelestialStore::is_empty(int index, const ShapeArena &arena) const {
+    const uint64_t *rows = masks(index, arena);
+    for (int i = 0; i < arena.height(shape_id[index]); ++i) {
+        if (rows[i]) return false;
+    }
+    return true;
+}
+
+bool CelestialStore::damage(int index, const ShapeArena &arena, int row, int col) {
+    uint64_t bit = 1ULL << col;
+    if (!(masks(index, arena)[row] & bit)) return false;
+
+    // First hit: take a private copy of the shared masks
+    if (damage_offset[index] < 0) {
+        int id = shape_id[index];
+        int height = arena.height(id);
+        damage_offset[index] = damage_words.size();
+        damage_words.resize(damage_words.size() + damage_block_size(index, arena), 0);
+        copy(arena.masks(id), arena.masks(id) + height, damage_words.begin() + damage_offset[index]);
+    }
+    damage_words[damage_offset[index] + row] &= ~bit;
+    shape_changed[index] = 1;
+    toggle_key(index, zobrist_key(ZOBRIST_DAMAGE, index, row * 64 + col));
+    return true;
+}
+
+void CelestialStore::destroy(int index) {
+    if (!alive[index]) return;
+    alive[index] = 0;
+    toggle_key(index, zobrist_key(ZOBRIST_DESTROYED, index, 0));
+}
@@ -0,0 +1,79 @@
+#ifndef CELESTIALSTORE_H
+#define CELESTIALSTORE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "LevelData.h"
+#include "ShapeArena.h"
+#include "Zobrist.h"
+
+using namespace std;
+
+// Structure-of-arrays storage for the per-tick state of every celestial object of a level.
+// Objects are indexed like the LevelData schedule, in order of appearance, so the tick loop walks
+// each column front to back. The loaded description of each object stays in the shared LevelData.
+class CelestialStore {
+public:
+    // Puts every object of the level in its loaded state (alive, undamaged, not drawn)
+    void reset(const LevelData &level);
+
+    // Puts one object back in its loaded state
+    void reset_object(int index, const LevelData &level);
+
+    // Number of objects in the store
+    int size() const { return shape_id.size(); }
+
+    // Row masks of an object's current shape, with damage applied
+    const uint64_t *masks(int index, const ShapeArena &arena) const {
+        return damage_offset[index] < 0 ? arena.masks(shape_id[index]) : &damage_words[damage_offset[index]];
+    }
+
+    // Number of words of an object's block in damage_words, one per row
+    int damage_block_size(int index, const ShapeArena &arena) const { return arena.height(shape_id[index]); }
+
+    // True if every cell of the object has been shot away
+    bool is_empty(int index, const ShapeArena &arena) const;
+
+    // Remove the cell at (row, col) of the current shape; returns false if it was already empty
+    bool damage(int index, const ShapeArena &arena, int row, int col);
+
+    // Marks the object destroyed, by a collision or by shots
+    void destroy(int index);
+
+    // Takes an object that leaves play out of zobrist_total; it never changes again
+    void retire(int index) { zobrist_total ^= zobrist[index]; }
+
+    // State that changes while playing
+    vector<int> shape_id;         // Shape in the ShapeArena
+    vector<uint8_t> alive;        // 0 once destroyed by a collision or by shots
+    vector<uint8_t> shape_changed;  // Damaged since last painted
+
+    // Footprint currently painted on the space grid
+    vector<uint8_t> on_grid;
+    vector<int> grid_row;
+    vector<int> grid_col;
+    vector<int> grid_rows;
+
+    // Width the object is registered with in the shot ColumnIndex, 0 if it is not registered
+    vector<int> indexed_width;
+
+    // Damaged objects keep private masks in damage_words starting at damage_offset (-1 while undamaged)
+    vector<int> damage_offset;
+    vector<uint64_t> damage_words;
+
+    // Zobrist key of each object's damage and destruction, 0 in the loaded state; a hit is keyed by
+    // the cell it removed. zobrist_total is the XOR of the keys of the objects in play: damage and
+    // destruction only happen to those, and retire() takes an object out when it leaves.
+    vector<uint64_t> zobrist;
+    uint64_t zobrist_total = 0;
+
+private:
+    // XORs a key into an object's key and the total
+    void toggle_key(int index, uint64_t key) {
+        zobrist[index] ^= key;
+        zobrist_total ^= key;
+    }
+};
+
+#endif // CELESTIALSTORE_H
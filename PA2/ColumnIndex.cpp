@@ -0,0 +1,31 @@
+#include "ColumnIndex.h"
+#include <algorithm>
+
+void ColumnIndex::reset(int window) {
+    buckets.assign(max(window, 1), vector<int>());
+}
+
+void ColumnIndex::clear() {
+    for (vector<int> &objects : buckets) {
+        objects.clear();
+    }
+}
+
+void ColumnIndex::insert(int object, long first_column, int width) {
+    width = min(width, static_cast<int>(buckets.size()));
+    for (int i = 0; i < width; ++i) {
+        buckets[bucket(first_column + i)].push_back(object);
+    }
+}
+
+void ColumnIndex::remove(int object, long first_column, int width) {
+    width = min(width, static_cast<int>(buckets.size()));
+    for (int i = 0; i < width; ++i) {
+        vector<int> &objects = buckets[bucket(first_column + i)];
+        auto it = find(objects.begin(), objects.end(), object);
+        if (it != objects.end()) {
+            *it = objects.back();
+            objects.pop_back();
+        }
+    }
+}
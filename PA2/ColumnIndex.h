@@ -0,0 +1,38 @@
+#ifndef COLUMNINDEX_H
+#define COLUMNINDEX_H
+
+#include <vector>
+
+using namespace std;
+
+// Per-column lists of the celestial objects covering each column of the space grid.
+// Columns are "world" columns: an object's world column is its grid column plus the tick it is
+// drawn at, which stays constant while it moves left one column per tick. The index therefore
+// only changes when objects appear, leave or change width, not on every tick.
+// Buckets form a ring, so any window of `window` consecutive world columns can be indexed.
+class ColumnIndex {
+public:
+    // Empties the index and sizes the ring for `window` consecutive world columns
+    void reset(int window);
+
+    // Empties the index but keeps the ring and its buckets' memory
+    void clear();
+
+    // Adds / removes an object covering world columns [first_column, first_column + width)
+    void insert(int object, long first_column, int width);
+    void remove(int object, long first_column, int width);
+
+    // Objects covering a world column. May also list objects from columns that alias in the ring,
+    // so callers must check the object's actual position.
+    const vector<int> &objects_at(long column) const { return buckets[bucket(column)]; }
+
+private:
+    int bucket(long column) const {
+        long b = column % static_cast<long>(buckets.size());
+        return static_cast<int>(b < 0 ? b + buckets.size() : b);
+    }
+
+    vector<vector<int>> buckets;
+};
+
+#endif // COLUMNINDEX_H
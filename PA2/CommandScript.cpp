@@ -0,0 +1,177 @@
+#include "CommandScript.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+bool CommandScript::read(const string &commands_file) {
+    return is_binary(commands_file) ? read_binary(commands_file) : read_text(commands_file);
+}
+
+bool CommandScript::read_text(const string &commands_file) {
+    ifstream file(commands_file);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open commands file: " << commands_file << endl;
+        return false;
+    }
+
+    actions.clear();
+    print_ticks.clear();
+    level_hash = 0;
+    string line;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string command;
+        ss >> command;
+        if (command == "PRINT_GRID") {
+            print_ticks.push_back(actions.size());
+        }
+        actions.push_back(parse_command(command));
+    }
+    file.close();
+    return true;
+}
+
+// Reads a little-endian unsigned integer of the given size
+static uint64_t read_little_endian(const unsigned char *bytes, int size) {
+    uint64_t value = 0;
+    for (int i = size - 1; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+static void write_little_endian(string &out, uint64_t value, int size) {
+    for (int i = 0; i < size; ++i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// The whole replay is read with one call and decoded in place into the preallocated action list.
+bool CommandScript::read_binary(const string &replay_file) {
+    auto load_start = chrono::steady_clock::now();
+
+    ifstream file(replay_file, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open replay file: " << replay_file << endl;
+        return false;
+    }
+    file.seekg(0, ios::end);
+    string buffer(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, ios::beg);
+    file.read(&buffer[0], buffer.size());
+    file.close();
+
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(buffer.data());
+    if (buffer.size() < REPLAY_HEADER_SIZE || memcmp(bytes, REPLAY_MAGIC, 4) != 0 || bytes[4] != REPLAY_VERSION) {
+        cerr << "Error: Not a replay file: " << replay_file << endl;
+        return false;
+    }
+    level_hash = read_little_endian(bytes + 8, 8);
+    uint64_t tick_count = read_little_endian(bytes + 16, 8);
+
+    // A byte covers at most REPLAY_MAX_NOP_RUN ticks, which bounds what a corrupt count can allocate
+    size_t body_size = buffer.size() - REPLAY_HEADER_SIZE;
+    if (tick_count > static_cast<uint64_t>(body_size) * REPLAY_MAX_NOP_RUN) {
+        cerr << "Error: Truncated replay file: " << replay_file << endl;
+        return false;
+    }
+
+    actions.resize(tick_count);
+    print_ticks.clear();
+    GameAction *out = actions.data();
+    GameAction *out_end = out + tick_count;
+    const unsigned char *pos = bytes + REPLAY_HEADER_SIZE;
+    const unsigned char *end = bytes + buffer.size();
+    for (; pos < end && out < out_end; ++pos) {
+        unsigned char code = *pos;
+        if (code & REPLAY_NOP_RUN) {
+            size_t run = min<size_t>((code & ~REPLAY_NOP_RUN) + 1, out_end - out);
+            fill(out, out + run, ACTION_NOP);
+            out += run;
+        } else if (code < ACTION_COUNT) {
+            *out++ = static_cast<GameAction>(code);
+        } else if (code == REPLAY_PRINT_GRID) {
+            size_t tick = out - actions.data();
+            if (!print_ticks.empty() && print_ticks.back() == tick) {
+                cerr << "Error: Tick " << tick << " is marked printed twice in " << replay_file << endl;
+                return false;
+            }
+            print_ticks.push_back(tick);
+        } else {
+            cerr << "Error: Unknown replay command " << static_cast<int>(code) << " in " << replay_file << endl;
+            return false;
+        }
+    }
+    // A print marker after the last tick has no tick to print
+    if (out != out_end || pos != end || (!print_ticks.empty() && print_ticks.back() >= tick_count)) {
+        cerr << "Error: Replay file does not match its tick count: " << replay_file << endl;
+        return false;
+    }
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - load_start).count();
+        cout << "Read " << tick_count << " ticks (" << buffer.size() << " bytes) from " << replay_file << " in "
+             << elapsed * 1000 << " ms, " << (elapsed > 0 ? buffer.size() / elapsed / 1e6 : 0) << " MB/s" << endl;
+    }
+    return true;
+}
+
+bool CommandScript::write_binary(const string &replay_file, uint64_t level_hash) const {
+    string out(REPLAY_MAGIC);
+    out += static_cast<char>(REPLAY_VERSION);
+    out.append(3, '\0');
+    write_little_endian(out, level_hash, 8);
+    write_little_endian(out, actions.size(), 8);
+
+    size_t next_print = 0;
+    for (size_t tick = 0; tick < actions.size();) {
+        // The marker is followed by the printed tick's own action
+        if (next_print < print_ticks.size() && print_ticks[next_print] == tick) {
+            out += static_cast<char>(REPLAY_PRINT_GRID);
+            ++next_print;
+        }
+        if (actions[tick] == ACTION_NOP) {
+            // A NOP run stops at the next printed tick
+            size_t limit = min(actions.size(), tick + REPLAY_MAX_NOP_RUN);
+            if (next_print < print_ticks.size()) limit = min(limit, print_ticks[next_print]);
+            size_t run = 1;
+            while (tick + run < limit && actions[tick + run] == ACTION_NOP) ++run;
+            out += static_cast<char>(REPLAY_NOP_RUN | (run - 1));
+            tick += run;
+        } else {
+            out += static_cast<char>(actions[tick]);
+            ++tick;
+        }
+    }
+
+    ofstream file(replay_file, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error: Unable to open replay file for writing: " << replay_file << endl;
+        return false;
+    }
+    file.write(out.data(), out.size());
+    return static_cast<bool>(file);
+}
+
+bool CommandScript::convert_text_to_binary(const string &commands_file, const string &replay_file,
+                                           uint64_t level_hash) {
+    CommandScript script;
+    return script.read_text(commands_file) && script.write_binary(replay_file, level_hash);
+}
+
+bool CommandScript::is_binary(const string &file_name) {
+    ifstream file(file_name, ios::binary);
+    char magic[4];
+    return file.read(magic, 4) && memcmp(magic, REPLAY_MAGIC, 4) == 0;
+}
+
+GameAction CommandScript::parse_command(const string &command) {
+    if (command == "MOVE_LEFT") return ACTION_MOVE_LEFT;
+    if (command == "MOVE_RIGHT") return ACTION_MOVE_RIGHT;
+    if (command == "MOVE_UP") return ACTION_MOVE_UP;
+    if (command == "MOVE_DOWN") return ACTION_MOVE_DOWN;
+    if (command == "SHOOT") return ACTION_SHOOT;
+    return ACTION_NOP;  // NOP, PRINT_GRID and unknown commands
+}
@@ -0,0 +1,60 @@
+#ifndef COMMANDSCRIPT_H
+#define COMMANDSCRIPT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AsteroidDash.h"
+
+using namespace std;
+
+// Binary replay layout (all integers little-endian):
+//   header: "ADRP", version byte, 3 zero bytes, level hash (uint64), tick count (uint64)
+//   body:   0..5 is one tick playing that GameAction, 0x80 | (n - 1) is a run of n NOP ticks
+//           (1 <= n <= 128), and REPLAY_PRINT_GRID marks the next tick as printed without being a tick
+//           itself, so a printed tick keeps its action
+#define REPLAY_MAGIC "ADRP"
+#define REPLAY_VERSION 1
+#define REPLAY_HEADER_SIZE 24
+#define REPLAY_PRINT_GRID 6
+#define REPLAY_NOP_RUN 0x80
+#define REPLAY_MAX_NOP_RUN 128
+
+// A commands file turned into one GameAction per tick, so it can be replayed many times without
+// touching the file again. Reads the text commands format and the binary replay format.
+class CommandScript {
+public:
+    // Actions in the order of the file, one per tick
+    vector<GameAction> actions;
+
+    // Ticks, in ascending order, at which the grid is printed before the action is played
+    vector<size_t> print_ticks;
+
+    // Level hash stored in a binary replay; 0 for text files
+    uint64_t level_hash = 0;
+
+    // Reads a commands file in either format. Returns false if it could not be read.
+    bool read(const string &commands_file);
+
+    // Reads a text commands file. PRINT_GRID and unknown commands become ACTION_NOP, since time still
+    // passes for them. Returns false if the file could not be opened.
+    bool read_text(const string &commands_file);
+
+    // Reads a binary replay. Returns false if the file could not be opened or is not a valid replay.
+    bool read_binary(const string &replay_file);
+
+    // Writes the script as a binary replay for the level with the given hash
+    bool write_binary(const string &replay_file, uint64_t level_hash) const;
+
+    // Converts a text commands file into a binary replay
+    static bool convert_text_to_binary(const string &commands_file, const string &replay_file, uint64_t level_hash);
+
+    // True if the file starts with the binary replay magic
+    static bool is_binary(const string &file_name);
+
+    // Action for one command word of a commands file
+    static GameAction parse_command(const string &command);
+};
+
+#endif // COMMANDSCRIPT_H
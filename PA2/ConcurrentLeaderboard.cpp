@@ -0,0 +1,103 @@
+#include "ConcurrentLeaderboard.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+ConcurrentLeaderboard::ConcurrentLeaderboard(Leaderboard &board, int shard_count)
+    : board(board), shards(max(shard_count, 1)) {
+    lock_guard<mutex> guard(board_lock);
+    update_threshold();
+}
+
+ConcurrentLeaderboard::~ConcurrentLeaderboard() {
+    flush();
+}
+
+bool ConcurrentLeaderboard::submit(unsigned long score, time_t last_played, const string &player_name) {
+    // Lock-free fast path: a full board only takes scores above its lowest one
+    if (board_full.load(memory_order_relaxed) && score <= lowest_score.load(memory_order_relaxed)) {
+        return false;
+    }
+
+    Shard &shard = local_shard();
+    bool should_merge;
+    {
+        lock_guard<mutex> guard(shard.lock);
+        shard.pending.push_back(LeaderboardRecord{score, last_played, player_name});
+        should_merge = shard.pending.size() >= LEADERBOARD_SHARD_BUFFER;
+    }
+    if (should_merge) {
+        merge(shard);
+    }
+    return true;
+}
+
+void ConcurrentLeaderboard::flush() {
+    for (Shard &shard : shards) {
+        merge(shard);
+    }
+}
+
+vector<LeaderboardRecord> ConcurrentLeaderboard::snapshot() {
+    flush();
+
+    vector<LeaderboardRecord> records;
+    lock_guard<mutex> guard(board_lock);
+    records.reserve(board.size());
+    for (LeaderboardEntry *entry = board.head_leaderboard_entry; entry; entry = entry->next) {
+        records.push_back(LeaderboardRecord{entry->score, entry->last_played, entry->player_name});
+    }
+    return records;
+}
+
+void ConcurrentLeaderboard::print_leaderboard() {
+    // Print the leaderboard in descending order of scores
+    for (LeaderboardRecord &record : snapshot()) {
+        cout << record.player_name << " " << record.score << " "
+             << ctime(&record.last_played);  // ctime() converts time_t to string
+    }
+}
+
+ConcurrentLeaderboard::Shard &ConcurrentLeaderboard::local_shard() {
+    static thread_local size_t thread_hash = hash<thread::id>()(this_thread::get_id());
+    return shards[thread_hash % shards.size()];
+}
+
+void ConcurrentLeaderboard::merge(Shard &shard) {
+    // Take the buffer so the shard's threads can keep submitting while it is merged
+    vector<LeaderboardRecord> pending;
+    {
+        lock_guard<mutex> guard(shard.lock);
+        if (shard.pending.empty()) return;
+        pending.swap(shard.pending);
+        shard.pending.reserve(LEADERBOARD_SHARD_BUFFER);
+    }
+
+    // Only the skip list inserts happen under board_lock
+    vector<LeaderboardRecord> accepted;
+    unique_lock<mutex> board_guard(board_lock);
+    for (LeaderboardRecord &record : pending) {
+        if (board.add(record.score, record.last_played, record.player_name)) {
+            accepted.push_back(move(record));
+        }
+    }
+    update_threshold();
+    if (accepted.empty()) return;
+
+    lock_guard<mutex> log_guard(log_lock);
+    if (board.compaction_due(accepted.size())) {
+        // The rewritten file holds every entry on the board, this batch's included
+        board.compact();
+        return;
+    }
+    board_guard.unlock();
+    board.append_to_log(accepted);
+}
+
+void ConcurrentLeaderboard::update_threshold() {
+    if (board.size() >= board.capacity && board.capacity > 0) {
+        lowest_score.store(board.at(board.size())->score, memory_order_relaxed);
+        board_full.store(true, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef CONCURRENTLEADERBOARD_H
+#define CONCURRENTLEADERBOARD_H
+
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Leaderboard.h"
+
+using namespace std;
+
+// Scores a ConcurrentLeaderboard shard holds before it merges them into the leaderboard
+#define LEADERBOARD_SHARD_BUFFER 32
+
+// Lets many game threads submit scores to one Leaderboard.
+// A submission first checks, without any lock, that the score beats the lowest score of a full
+// board; most scores stop there. The others go into a small buffer of one of the shards, picked by
+// thread, and each full buffer is merged into the leaderboard under a single lock. The scores that
+// make the board are then appended to the leaderboard file in one write, after that lock is let go.
+// Reads flush every shard and copy the board under that lock, so they see one consistent state.
+class ConcurrentLeaderboard {
+public:
+    // Submissions are merged into board, which must outlive this object and not be used directly meanwhile
+    explicit ConcurrentLeaderboard(Leaderboard &board, int shard_count = 64);
+
+    // Merges whatever is still buffered
+    ~ConcurrentLeaderboard();
+
+    ConcurrentLeaderboard(const ConcurrentLeaderboard &) = delete;
+    ConcurrentLeaderboard &operator=(const ConcurrentLeaderboard &) = delete;
+
+    // Records a score. Returns false if it was rejected right away for being too low; a score
+    // that passes may still drop off the board when it is merged.
+    bool submit(unsigned long score, time_t last_played, const string &player_name);
+
+    // Merges every shard's buffer into the leaderboard
+    void flush();
+
+    // The merged leaderboard, best first, after flushing every shard
+    vector<LeaderboardRecord> snapshot();
+
+    // Prints a snapshot in the format of Leaderboard::print_leaderboard
+    void print_leaderboard();
+
+private:
+    struct alignas(64) Shard {
+        mutex lock;
+        vector<LeaderboardRecord> pending;
+    };
+
+    // Shard of the calling thread
+    Shard &local_shard();
+
+    // Moves a shard's buffer into the leaderboard
+    void merge(Shard &shard);
+
+    // Updates the fast-path threshold; board_lock must be held
+    void update_threshold();
+
+    Leaderboard &board;
+    vector<Shard> shards;
+    mutex board_lock;
+
+    // Guards the leaderboard file. A merge takes it before letting go of board_lock, so batches reach
+    // the file in the order they reached the board; it is never held while waiting for board_lock.
+    mutex log_lock;
+
+    // Score of the lowest entry once the board is full; scores not above it are rejected
+    atomic<bool> board_full{false};
+    atomic<unsigned long> lowest_score{0};
+};
+
+#endif // CONCURRENTLEADERBOARD_H
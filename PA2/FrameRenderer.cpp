@@ -0,0 +1,190 @@
+#include "FrameRenderer.h"
+#include <algorithm>
+
+// Number of code points in a UTF-8 string, i.e. terminal columns for the block characters we draw
+static int display_columns(const string &text) {
+    int columns = 0;
+    for (char c : text) {
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) ++columns;
+    }
+    return columns;
+}
+
+FrameRenderer::FrameRenderer(const string &occupied, const string &unoccupied, RenderMode mode, int planes,
+                             int covering_planes)
+    : mode(mode), occupied(occupied), unoccupied(unoccupied), cell_columns(max(1, display_columns(occupied))),
+      planes(planes), covering_planes(covering_planes) {}
+
+void FrameRenderer::render(const SpaceGrid &grid, ostream &out) {
+    buffer.clear();
+    words.resize(grid.get_words_per_row());
+
+    if (mode == RENDER_LIVE && has_previous && previous_height == grid.get_height() &&
+        previous_width == grid.get_width()) {
+        render_diff(grid);
+    } else {
+        if (mode == RENDER_LIVE) {
+            buffer += "\x1b[H\x1b[2J";  // Cursor home, clear screen
+        }
+        render_full(grid);
+    }
+
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+}
+
+uint64_t FrameRenderer::occupied_word(const SpaceGrid &grid, int row, int w) const {
+    uint64_t shown = 0, covered = 0;
+    for (int plane = PLAYER_PLANE; plane <= OBJECT_PLANE; ++plane) {
+        if (planes & (1 << plane)) shown |= grid.row_word(static_cast<GridPlane>(plane), row, w);
+        if (covering_planes & (1 << plane)) covered |= grid.row_word(static_cast<GridPlane>(plane), row, w);
+    }
+    return shown & ~covered;
+}
+
+void FrameRenderer::occupied_words(const SpaceGrid &grid, int row, uint64_t *words) const {
+    int count = grid.get_words_per_row();
+    for (int w = 0; w < count; ++w) {
+        words[w] = occupied_word(grid, row, w);
+    }
+}
+
+bool FrameRenderer::occupied_tile(const SpaceGrid &grid, size_t tile, uint64_t *words) const {
+    int tile_row = tile / grid.get_tile_cols(), tile_col = tile % grid.get_tile_cols();
+    fill(words, words + GRID_TILE_SIZE, 0);
+    uint64_t covered[GRID_TILE_SIZE] = {};
+    for (int plane = PLAYER_PLANE; plane <= OBJECT_PLANE; ++plane) {
+        const uint64_t *tile_words = grid.tile_words(static_cast<GridPlane>(plane), tile_row, tile_col);
+        if (!tile_words) continue;
+        for (int r = 0; r < GRID_TILE_SIZE; ++r) {
+            if (planes & (1 << plane)) words[r] |= tile_words[r];
+            if (covering_planes & (1 << plane)) covered[r] |= tile_words[r];
+        }
+    }
+    uint64_t any = 0;
+    for (int r = 0; r < GRID_TILE_SIZE; ++r) {
+        words[r] &= ~covered[r];
+        any |= words[r];
+    }
+    return any != 0;
+}
+
+void FrameRenderer::append_cells(bool occupied_cells, int count) {
+    const string &cell = occupied_cells ? occupied : unoccupied;
+    for (int i = 0; i < count; ++i) {
+        buffer += cell;
+    }
+}
+
+void FrameRenderer::move_cursor(int row, int col, int &cursor_row, int &cursor_col) {
+    if (row != cursor_row || col != cursor_col) {
+        // Terminal rows and columns start at 1
+        buffer += "\x1b[";
+        buffer += to_string(row + 1);
+        buffer += ';';
+        buffer += to_string(col * cell_columns + 1);
+        buffer += 'H';
+    }
+    cursor_row = row;
+    cursor_col = col;
+}
+
+void FrameRenderer::render_full(const SpaceGrid &grid) {
+    int height = grid.get_height(), width = grid.get_width();
+    buffer.reserve(buffer.size() + static_cast<size_t>(height) * (width * max(occupied.size(), unoccupied.size()) + 1));
+
+    for (int row = 0; row < height; ++row) {
+        occupied_words(grid, row, words.data());
+        for (int col = 0; col < width;) {
+            // Append the run of equal cells starting at col
+            bool bit = words[col >> 6] >> (col & 63) & 1;
+            int end = col + 1;
+            while (end < width && (words[end >> 6] >> (end & 63) & 1) == bit) ++end;
+            append_cells(bit, end - col);
+            col = end;
+        }
+        buffer += '\n';
+    }
+
+    if (mode == RENDER_LIVE) {
+        // Remember the non-empty tiles for the next frame
+        previous.clear();
+        uint64_t tile_words[GRID_TILE_SIZE];
+        for (size_t i = 0; i < grid.allocated_tiles(); ++i) {
+            size_t tile = grid.allocated_tile(i);
+            if (occupied_tile(grid, tile, tile_words)) {
+                previous[tile].assign(tile_words, tile_words + GRID_TILE_SIZE);
+            }
+        }
+        has_previous = true;
+        previous_height = height;
+        previous_width = grid.get_width();
+    }
+}
+
+void FrameRenderer::render_diff(const SpaceGrid &grid) {
+    int height = grid.get_height(), tile_cols = grid.get_tile_cols();
+    int cursor_row = -1, cursor_col = -1;  // Cell the terminal cursor is on, -1 if unknown
+
+    // Only tiles that are allocated now or were drawn last frame can have changed. Sorted, they
+    // come tile row by tile row, so cells are written in reading order.
+    vector<size_t> candidates;
+    candidates.reserve(grid.allocated_tiles() + previous.size());
+    for (size_t i = 0; i < grid.allocated_tiles(); ++i) {
+        candidates.push_back(grid.allocated_tile(i));
+    }
+    for (const auto &entry : previous) {
+        candidates.push_back(entry.first);
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+    vector<uint64_t> current(GRID_TILE_SIZE);
+    vector<const uint64_t *> before;  // Last frame of each candidate tile of a tile row, nullptr if empty
+    for (size_t first = 0; first < candidates.size();) {
+        // The candidate tiles [first, last) share a tile row
+        int tile_row = candidates[first] / tile_cols;
+        size_t last = first;
+        while (last < candidates.size() && static_cast<int>(candidates[last] / tile_cols) == tile_row) ++last;
+
+        before.clear();
+        for (size_t i = first; i < last; ++i) {
+            auto it = previous.find(candidates[i]);
+            before.push_back(it == previous.end() ? nullptr : it->second.data());
+        }
+
+        int rows = min(GRID_TILE_SIZE, height - tile_row * GRID_TILE_SIZE);
+        for (int r = 0; r < rows; ++r) {
+            int row = tile_row * GRID_TILE_SIZE + r;
+            for (size_t i = first; i < last; ++i) {
+                int w = candidates[i] % tile_cols;
+                uint64_t now = occupied_word(grid, row, w);
+                uint64_t changed = now ^ (before[i - first] ? before[i - first][r] : 0);
+                while (changed) {
+                    int col = (w << 6) + __builtin_ctzll(changed);
+                    changed &= changed - 1;
+                    move_cursor(row, col, cursor_row, cursor_col);
+                    append_cells(now >> (col & 63) & 1, 1);
+                    ++cursor_col;
+                }
+            }
+        }
+
+        // Remember this tile row for the next frame
+        for (size_t i = first; i < last; ++i) {
+            if (occupied_tile(grid, candidates[i], current.data())) {
+                previous[candidates[i]] = current;
+            } else {
+                previous.erase(candidates[i]);
+            }
+        }
+        first = last;
+    }
+
+    // Leave the cursor under the grid, where a full frame would have left it
+    if (cursor_row >= 0) {
+        buffer += "\x1b[";
+        buffer += to_string(height + 1);
+        buffer += ";1H";
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SpaceGrid.h"
+
+using namespace std;
+
+// How a FrameRenderer writes successive frames
+enum RenderMode {
+    RENDER_FULL = 0,  // Every frame in full, one line per row, like a log
+    RENDER_LIVE = 1   // Frames drawn over each other; after the first only the changed cells are written
+};
+
+// Draws the space grid as text. A frame is built in one buffer that is kept between frames and
+// written to the stream with a single write. In live mode the renderer remembers the last frame
+// and only moves the cursor to the cells that changed, using ANSI escape codes; it keeps the last
+// frame per grid tile and only compares the tiles allocated now or in the last frame.
+class FrameRenderer {
+public:
+    // occupied / unoccupied are the strings drawn for one cell; planes is a bit set of the
+    // GridPlanes whose cells count as occupied, and covering_planes of those painted over them,
+    // whose cells never count as occupied
+    FrameRenderer(const string &occupied, const string &unoccupied, RenderMode mode = RENDER_FULL,
+                  int planes = (1 << PLAYER_PLANE) | (1 << OBJECT_PLANE), int covering_planes = 0);
+
+    // Draws one frame of the grid
+    void render(const SpaceGrid &grid, ostream &out = cout);
+
+    // Forgets the last frame, so the next live frame is drawn in full
+    void invalidate() {
+        previous.clear();
+        has_previous = false;
+    }
+
+    RenderMode mode;
+
+private:
+    // Occupied cells of word w of a row
+    uint64_t occupied_word(const SpaceGrid &grid, int row, int w) const;
+
+    // Occupied cells of a row of the grid, one bit per cell
+    void occupied_words(const SpaceGrid &grid, int row, uint64_t *words) const;
+
+    // Occupied cells of one tile of the grid, one word per tile row; false if the tile is empty
+    bool occupied_tile(const SpaceGrid &grid, size_t tile, uint64_t *words) const;
+
+    // Moves the cursor to a cell unless it is already there
+    void move_cursor(int row, int col, int &cursor_row, int &cursor_col);
+
+    // Appends count cells of one kind
+    void append_cells(bool occupied, int count);
+
+    void render_full(const SpaceGrid &grid);
+    void render_diff(const SpaceGrid &grid);
+
+    string occupied;
+    string unoccupied;
+    int cell_columns;  // Terminal columns taken by one cell
+    int planes;
+    int covering_planes;
+
+    string buffer;           // The frame being built
+    vector<uint64_t> words;  // One row of occupied cells
+
+    // Occupied cells of the last live frame by tile index, for its non-empty tiles only
+    unordered_map<size_t, vector<uint64_t>> previous;
+    bool has_previous = false;
+    int previous_height = 0;
+    int previous_width = 0;
+};
+
+#endif // FRAMERENDERER_H
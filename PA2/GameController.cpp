@@ -1,6 +1,7 @@
 #include "GameController.h"
-#include <fstream>
-#include <sstream>
+#include "Autopilot.h"
+#include "CommandScript.h"
+#include "TickProfiler.h"
 
 // Simply instantiates the game
 GameController::GameController(
@@ -15,51 +16,72 @@ GameController::GameController(
     // Additional initializations can be done here if needed
 }
 
-// Reads commands from the given input file, executes each command in a game tick
+// Reads commands from the given input file, executes each command in a game tick.
+// The file can be a text commands file or a binary replay recorded on the same level.
 void GameController::play(const string &commands_file) {
-    ifstream file(commands_file);
-    string line;
-
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string command;
-        ss >> command;
+    // The summary at the end covers this run only, not earlier runs on the same thread
+    PROFILE_RESET();
+    CommandScript script;
+    {
+        PROFILE_PHASE(PHASE_PARSE);
+        if (!script.read(commands_file)) return;
+    }
+    if (script.level_hash != 0 && script.level_hash != game->level->hash()) {
+        cerr << "Error: Replay " << commands_file << " was recorded on a different level." << endl;
+        return;
+    }
 
-        if (command == "MOVE_LEFT") {
-            game->player->move_left();
-        } else if (command == "MOVE_RIGHT") {
-            game->player->move_right(game->space_grid[0].size());
-        } else if (command == "MOVE_UP") {
-            game->player->move_up();
-        } else if (command == "MOVE_DOWN") {
-            game->player->move_down(game->space_grid.size());
-        } else if (command == "SHOOT") {
-            game->shoot();
-        } else if (command == "NOP") {
-            continue;
-        } else if (command == "PRINT_GRID") {
+    size_t next_print = 0;
+    for (size_t tick = 0; tick < script.actions.size(); ++tick) {
+        GameAction action = script.actions[tick];
+        if (action == ACTION_SHOOT && game->player && game->player->current_ammo <= 0) {
+            cout << "No ammo left!" << endl;
+        }
+        // A replay may print a tick that also plays an action
+        if (next_print < script.print_ticks.size() && script.print_ticks[next_print] == tick) {
             // Print the updated state of the grid after processing the game tick
-            for (size_t i = 0; i < game->space_grid.size(); ++i) {
-                for (size_t j = 0; j < game->space_grid[i].size(); ++j) {
-                    // Check for the player or celestial objects
-                    if (game->space_grid[i][j] == 1) {  // This is just an example condition
-                        // If there is something important like the player or an object, print it
-                        cout << 'O';  // O for celestial object or player (or any object)
-                    } else {
-                        cout << '.';  // Empty space
-                    }
-                }
-                cout << endl;  // Move to the next line after each row
+            PROFILE_PHASE(PHASE_RENDER);
+            grid_renderer.render(game->space_grid);
+            ++next_print;
+        }
+
+        // A run of NOPs is played in one go; it ends at the next other command or printed tick
+        if (action == ACTION_NOP) {
+            size_t run_end = tick + 1;
+            size_t run_limit = next_print < script.print_ticks.size() ? script.print_ticks[next_print]
+                                                                       : script.actions.size();
+            while (run_end < run_limit && script.actions[run_end] == ACTION_NOP) ++run_end;
+            unsigned long played;
+            {
+                PROFILE_PHASE(PHASE_FAST_FORWARD);
+                played = game->fast_forward(run_end - tick);
+            }
+            if (played < run_end - tick || game->game_over) {
+                break;
             }
+            tick = run_end - 1;
+            continue;
         }
 
         // Update game state after every command (such as player movement, celestial object movements, etc.)
-        game->update_space_grid();
-
-        // More commands can be added here if necessary
+        if (game->step(action).done) {
+            break;
+        }
     }
 
-    file.close();
+    // Per-phase timings of this run, when built with ASTEROIDDASH_PROFILE
+    PROFILE_SUMMARY();
+}
+
+// Plays the game with rollouts instead of a commands file, e.g. to get a reference score for a new level
+void GameController::autopilot(unsigned long ticks, const string &replay_file, int threads) {
+    Autopilot pilot(game->level, threads);
+    CommandScript script;
+    pilot.play(*game, ticks, &script.actions);
+
+    if (!replay_file.empty() && !script.write_binary(replay_file, game->level->hash())) {
+        cerr << "Error: Unable to write replay file: " << replay_file << endl;
+    }
 }
 
 // Destructor to delete dynamically allocated member variables here
@@ -15,6 +15,10 @@ public:
     // Game instance
     AsteroidDash *game;
 
+    // Draws the grid for PRINT_GRID: 'O' for the player's cells that no object is painted over, '.'
+    // for everything else
+    FrameRenderer grid_renderer{"O", ".", RENDER_FULL, 1 << PLAYER_PLANE, 1 << OBJECT_PLANE};
+
     // Constructor
     GameController(
             const string &space_grid_file_name,
@@ -27,6 +31,10 @@ public:
     // Reads commands from the given input file, executes each command in a tick
     void play(const string &commands_file);
 
+    // Lets an Autopilot play up to ticks ticks from the current state, on threads threads (0 for all cores).
+    // If replay_file is not empty, the moves it chose are written there as a binary replay.
+    void autopilot(unsigned long ticks, const string &replay_file = "", int threads = 0);
+
     // Destructor to delete dynamically allocated member variables here
     virtual ~GameController();
 };
@@ -1,12 +1,21 @@
 #include "Leaderboard.h"
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
+Leaderboard::Leaderboard(size_t capacity)
+    : capacity(capacity), head_skip(LEADERBOARD_SKIP_LEVELS - 1, LeaderboardEntry::SkipLink{nullptr, 1}) {}
+
 // Read the stored leaderboard status from the given file such that the "head_leaderboard_entry" member
 // variable will point to the highest all-times score, and all other scores will be reachable from it
 // via the "next_leaderboard_entry" member variable pointer.
+// Every line of the file is a submission; the best `capacity` of them are kept.
 void Leaderboard::read_from_file(const string &filename) {
+    log_file_name = filename;
+    log_lines = 0;
+
     ifstream file(filename);
     if (!file.is_open()) {
         return;  // No leaderboard file found, nothing to load
@@ -19,7 +28,8 @@ void Leaderboard::read_from_file(const string &filename) {
         time_t timestamp;
         string player_name;
 
-        ss >> score >> timestamp >> player_name;
+        if (!(ss >> score >> timestamp >> player_name)) continue;
+        ++log_lines;
 
         // Create a new entry for each line in the leaderboard file
         LeaderboardEntry *new_entry = new LeaderboardEntry(score, timestamp, player_name);
@@ -32,7 +42,8 @@ void Leaderboard::read_from_file(const string &filename) {
 }
 
 
-// Write the latest leaderboard status to the given file in the format specified in the PA instructions
+// Write the latest leaderboard status to the given file in the format specified in the PA instructions.
+// The lines are in the order read_from_file expects them: score, timestamp, name.
 void Leaderboard::write_to_file(const string &filename) {
     ofstream output_file(filename);
 
@@ -43,7 +54,7 @@ void Leaderboard::write_to_file(const string &filename) {
 
     LeaderboardEntry *current = head_leaderboard_entry;
     while (current != nullptr) {
-        output_file << current->score << " " << current->player_name << " " << current->last_played << endl;
+        output_file << current->score << " " << current->last_played << " " << current->player_name << "\n";
         current = current->next;
     }
 
@@ -62,41 +73,220 @@ void Leaderboard::print_leaderboard() {
     }
 }
 
+LeaderboardEntry *&Leaderboard::link(LeaderboardEntry *node, int level) {
+    if (level == 0) return node ? node->next : head_leaderboard_entry;
+    return (node ? node->skip : head_skip)[level - 1].next;
+}
+
+LeaderboardEntry *Leaderboard::link(const LeaderboardEntry *node, int level) const {
+    if (level == 0) return node ? node->next : head_leaderboard_entry;
+    return (node ? node->skip : head_skip)[level - 1].next;
+}
+
+// A link to the end of the list spans the remaining entries plus one
+size_t Leaderboard::width(const LeaderboardEntry *node, int level) const {
+    if (level == 0) return 1;
+    return (node ? node->skip : head_skip)[level - 1].width;
+}
+
+void Leaderboard::set_width(LeaderboardEntry *node, int level, size_t width) {
+    if (level == 0) return;
+    (node ? node->skip : head_skip)[level - 1].width = width;
+}
+
+int Leaderboard::random_level() {
+    // xorshift64
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    int level = 1;
+    uint64_t bits = random_state;
+    while (level < LEADERBOARD_SKIP_LEVELS && (bits & 3) == 0) {
+        ++level;
+        bits >>= 2;
+    }
+    return level;
+}
+
 //  Insert a new LeaderboardEntry instance into the leaderboard, such that the order of the high-scores
-//  is maintained, and the leaderboard size does not exceed 10 entries at any given time (only the
-//  top 10 all-time high-scores should be kept in descending order by the score).
+//  is maintained, and the leaderboard size does not exceed `capacity` entries at any given time (only the
+//  top all-time high-scores are kept in descending order by the score). Equal scores keep their
+//  insertion order.
 void Leaderboard::insert(LeaderboardEntry *new_entry) {
-    if (head_leaderboard_entry == nullptr || new_entry->score > head_leaderboard_entry->score) {
-        // Insert at the beginning if the list is empty or the score is the highest
-        new_entry->next = head_leaderboard_entry;
-        head_leaderboard_entry = new_entry;
-    } else {
-        LeaderboardEntry *current = head_leaderboard_entry;
-        while (current->next != nullptr && current->next->score >= new_entry->score) {
-            current = current->next;
+    // A full board only takes scores above its lowest one
+    if (entry_count >= capacity && (capacity == 0 || last_entry->score >= new_entry->score)) {
+        delete new_entry;
+        return;
+    }
+
+    // Find the last entry with a score >= the new one on every level, and its position
+    LeaderboardEntry *update[LEADERBOARD_SKIP_LEVELS];
+    size_t update_rank[LEADERBOARD_SKIP_LEVELS];
+    LeaderboardEntry *node = nullptr;
+    size_t position = 0;
+    for (int level = levels - 1; level >= 0; --level) {
+        LeaderboardEntry *next_node;
+        while ((next_node = link(node, level)) != nullptr && next_node->score >= new_entry->score) {
+            position += width(node, level);
+            node = next_node;
         }
-        // Insert the new entry in the correct place
-        new_entry->next = current->next;
-        current->next = new_entry;
+        update[level] = node;
+        update_rank[level] = position;
     }
 
-    // Ensure the leaderboard size doesn't exceed MAX_LEADERBOARD_SIZE
-    int count = 0;
-    LeaderboardEntry *current = head_leaderboard_entry;
-    while (current != nullptr) {
-        count++;
-        current = current->next;
+    int height = random_level();
+    for (int level = levels; level < height; ++level) {
+        update[level] = nullptr;
+        update_rank[level] = 0;
+        set_width(nullptr, level, entry_count + 1);
+    }
+    levels = max(levels, height);
+
+    // Link the entry in after its predecessors; it lands at position + 1
+    new_entry->skip.assign(height - 1, LeaderboardEntry::SkipLink{nullptr, 1});
+    for (int level = 0; level < height; ++level) {
+        size_t span = width(update[level], level);
+        size_t before = position - update_rank[level];
+        link(new_entry, level) = link(update[level], level);
+        link(update[level], level) = new_entry;
+        set_width(new_entry, level, span - before);
+        set_width(update[level], level, before + 1);
+    }
+    for (int level = height; level < levels; ++level) {
+        set_width(update[level], level, width(update[level], level) + 1);
+    }
+    if (new_entry->next == nullptr) last_entry = new_entry;
+    ++entry_count;
+
+    // Ensure the leaderboard size doesn't exceed its capacity
+    while (entry_count > capacity) {
+        erase_at(entry_count);
+    }
+}
+
+void Leaderboard::erase_at(size_t rank) {
+    if (rank == 0 || rank > entry_count) return;
+
+    LeaderboardEntry *update[LEADERBOARD_SKIP_LEVELS] = {};
+    LeaderboardEntry *node = nullptr;
+    size_t position = 0;
+    for (int level = levels - 1; level >= 0; --level) {
+        while (link(node, level) != nullptr && position + width(node, level) < rank) {
+            position += width(node, level);
+            node = link(node, level);
+        }
+        update[level] = node;
+    }
+
+    LeaderboardEntry *target = link(update[0], 0);
+    for (int level = 0; level < levels; ++level) {
+        if (link(update[level], level) == target) {
+            set_width(update[level], level, width(update[level], level) + width(target, level) - 1);
+            link(update[level], level) = link(target, level);
+        } else {
+            set_width(update[level], level, width(update[level], level) - 1);
+        }
     }
+    while (levels > 1 && head_skip[levels - 2].next == nullptr) {
+        --levels;
+    }
+    if (target == last_entry) last_entry = update[0];
+    delete target;
+    --entry_count;
+}
+
+size_t Leaderboard::rank(unsigned long score) const {
+    const LeaderboardEntry *node = nullptr;
+    size_t position = 0;
+    for (int level = levels - 1; level >= 0; --level) {
+        const LeaderboardEntry *next_node;
+        while ((next_node = link(node, level)) != nullptr && next_node->score >= score) {
+            position += width(node, level);
+            node = next_node;
+        }
+    }
+    return position + 1;
+}
+
+LeaderboardEntry *Leaderboard::at(size_t rank) const {
+    if (rank == 0 || rank > entry_count) return nullptr;
+
+    const LeaderboardEntry *node = nullptr;
+    size_t position = 0;
+    for (int level = levels - 1; level >= 0; --level) {
+        while (link(node, level) != nullptr && position + width(node, level) <= rank) {
+            position += width(node, level);
+            node = link(node, level);
+        }
+    }
+    return const_cast<LeaderboardEntry *>(node);
+}
+
+bool Leaderboard::submit(unsigned long score, time_t last_played, const string &player_name) {
+    if (!add(score, last_played, player_name)) {
+        return false;
+    }
+    if (open_log()) {
+        write_log_line(score, last_played, player_name);
+        log_file.flush();
+    }
+
+    // Rewrite the file once most of its lines are scores that dropped off the board
+    if (compaction_due()) {
+        compact();
+    }
+    return true;
+}
+
+bool Leaderboard::add(unsigned long score, time_t last_played, const string &player_name) {
+    if (entry_count >= capacity && (capacity == 0 || last_entry->score >= score)) {
+        return false;
+    }
+    insert(new LeaderboardEntry(score, last_played, player_name));
+    return true;
+}
+
+void Leaderboard::append_to_log(const vector<LeaderboardRecord> &records) {
+    if (records.empty() || !open_log()) return;
+    for (const LeaderboardRecord &record : records) {
+        write_log_line(record.score, record.last_played, record.player_name);
+    }
+    log_file.flush();
+}
+
+bool Leaderboard::compaction_due(size_t pending_lines) const {
+    return log_lines + pending_lines > 2 * entry_count + LEADERBOARD_COMPACTION_SLACK;
+}
 
-    // If the list is too large, remove the last entry
-    if (count > MAX_LEADERBOARD_SIZE) {
-        current = head_leaderboard_entry;
-        for (int i = 1; i < count - 1; i++) {
-            current = current->next;
+bool Leaderboard::open_log() {
+    if (log_file_name.empty()) return false;
+    if (!log_file.is_open()) {
+        log_file.open(log_file_name, ios::app);
+        if (!log_file.is_open()) {
+            cout << "Error: Unable to open file for writing." << endl;
+            return false;
         }
-        delete current->next;
-        current->next = nullptr;
     }
+    return true;
+}
+
+void Leaderboard::write_log_line(unsigned long score, time_t last_played, const string &player_name) {
+    log_file << score << " " << last_played << " " << player_name << "\n";
+    ++log_lines;
+}
+
+void Leaderboard::compact() {
+    if (log_file_name.empty()) return;
+
+    // Write the new file next to the old one and swap it in, so a crash leaves one of them whole
+    if (log_file.is_open()) log_file.close();
+    string compacted_file_name = log_file_name + ".tmp";
+    write_to_file(compacted_file_name);
+    if (rename(compacted_file_name.c_str(), log_file_name.c_str()) != 0) {
+        cout << "Error: Unable to replace " << log_file_name << endl;
+        return;
+    }
+    log_lines = entry_count;
 }
 
 // Free dynamically allocated memory used for storing leaderboard entries
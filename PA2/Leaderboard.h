@@ -1,21 +1,51 @@
 #ifndef LEADERBOARD_H
 #define LEADERBOARD_H
 
+#include <cstdint>
 #include <ctime>
+#include <fstream>
 #include <string>
+#include <vector>
 #include "LeaderboardEntry.h"
 
 #define MAX_LEADERBOARD_SIZE 10
 
+// Levels of the skip list; enough for far more entries than fit in memory with p = 1/4
+#define LEADERBOARD_SKIP_LEVELS 24
+
+// Lines the leaderboard file may hold beyond twice the entries before it is compacted
+#define LEADERBOARD_COMPACTION_SLACK 64
+
 using namespace std;
 
+// One score and who set it, as passed around outside the leaderboard's own entries
+struct LeaderboardRecord {
+    unsigned long score;
+    time_t last_played;
+    string player_name;
+};
+
+// High scores in descending order, at most `capacity` of them.
+// The entries form a linked list from head_leaderboard_entry through next, as they always did; the
+// list is also the bottom level of an indexable skip list, so inserting and finding an entry or a rank
+// take O(log n). The leaderboard file is a log of "score timestamp name" lines: a submission appends
+// one line, and the file is only rewritten with the current entries once it has grown to about twice
+// their number.
 class Leaderboard {
 public:
 
+    explicit Leaderboard(size_t capacity = MAX_LEADERBOARD_SIZE);
+
+    Leaderboard(const Leaderboard &) = delete;
+    Leaderboard &operator=(const Leaderboard &) = delete;
+
     // Pointer to the head of the linked list
     LeaderboardEntry *head_leaderboard_entry = nullptr;
 
-    // Read the stored leaderboard status from the given file
+    // Maximum number of entries kept
+    size_t capacity;
+
+    // Read the stored leaderboard status from the given file; later submissions are appended to it
     void read_from_file(const string &filename);
 
     // Write the latest leaderboard status to the given file
@@ -27,8 +57,64 @@ public:
     //  Insert a new LeaderboardEntry instance into the leaderboard
     void insert(LeaderboardEntry *new_entry);
 
+    // Records a score: inserts it and appends it to the leaderboard file if it makes the board.
+    // Returns false if the score is too low to be kept.
+    bool submit(unsigned long score, time_t last_played, const string &player_name);
+
+    // Inserts a score without logging it; returns false if it is too low to be kept
+    bool add(unsigned long score, time_t last_played, const string &player_name);
+
+    // Appends the lines of scores accepted by add to the leaderboard file, with one flush
+    void append_to_log(const vector<LeaderboardRecord> &records);
+
+    // True once the file, with pending_lines more lines, would be due for compact()
+    bool compaction_due(size_t pending_lines = 0) const;
+
+    // Rewrites the leaderboard file with only the current entries
+    void compact();
+
+    // Number of entries
+    size_t size() const { return entry_count; }
+
+    // Position (1 = best) a new entry with this score would get, after the entries with equal scores
+    size_t rank(unsigned long score) const;
+
+    // Entry at a 1-based position, nullptr if there are fewer entries
+    LeaderboardEntry *at(size_t rank) const;
+
     // Free dynamically allocated memory used for storing leaderboard entries
     virtual ~Leaderboard();
+
+private:
+    // Link and width of a node on a level; a null node is the head of the list
+    LeaderboardEntry *&link(LeaderboardEntry *node, int level);
+    LeaderboardEntry *link(const LeaderboardEntry *node, int level) const;
+    size_t width(const LeaderboardEntry *node, int level) const;
+    void set_width(LeaderboardEntry *node, int level, size_t width);
+
+    // Height for a new node, each extra level with probability 1/4
+    int random_level();
+
+    // Removes and deletes the entry at a 1-based position
+    void erase_at(size_t rank);
+
+    // Opens the leaderboard file for appending; false if there is none or it cannot be opened
+    bool open_log();
+
+    // Writes one line to the open leaderboard file, without flushing
+    void write_log_line(unsigned long score, time_t last_played, const string &player_name);
+
+    // Skip list head above the bottom level, indexed like LeaderboardEntry::skip
+    vector<LeaderboardEntry::SkipLink> head_skip;
+    int levels = 1;
+    size_t entry_count = 0;
+    LeaderboardEntry *last_entry = nullptr;  // Lowest entry, the one a full board drops first
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+    // Leaderboard file the entries are appended to, and the number of lines it holds
+    string log_file_name;
+    ofstream log_file;
+    size_t log_lines = 0;
 };
 
 
@@ -1,4 +1,5 @@
 #include "LeaderboardEntry.h"
+#include "NodePool.h"
 
 // Constructor. You can leave it as it is
 LeaderboardEntry::LeaderboardEntry(unsigned long score,
@@ -10,4 +11,15 @@ LeaderboardEntry::LeaderboardEntry(unsigned long score,
     // TODO: Your code here, if you want to do further initializations
 }
 
+void *LeaderboardEntry::operator new(size_t size) {
+    // Classes derived from this one are larger than a pool node
+    return size == sizeof(LeaderboardEntry) ? NodePool<LeaderboardEntry>::allocate() : ::operator new(size);
+}
 
+void LeaderboardEntry::operator delete(void *pointer, size_t size) {
+    if (size == sizeof(LeaderboardEntry)) {
+        NodePool<LeaderboardEntry>::deallocate(pointer);
+    } else {
+        ::operator delete(pointer);
+    }
+}
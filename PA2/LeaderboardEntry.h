@@ -1,8 +1,10 @@
 #ifndef LEADERBOARDENTRY_H
 #define LEADERBOARDENTRY_H
 
+#include <cstddef>
 #include <ctime>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -14,6 +16,10 @@ public:
     // Constructor
     LeaderboardEntry(unsigned long score, time_t lastPlayed, const string &playerName);
 
+    // Nodes come from a NodePool instead of one heap allocation each
+    static void *operator new(size_t size);
+    static void operator delete(void *pointer, size_t size);
+
     // Score of the player
     unsigned long score;
 
@@ -23,8 +29,17 @@ public:
     // Player name
     string player_name;
 
-    // Next entry in the linked list
+    // Next entry in the linked list; also the bottom level of the leaderboard's skip list
     LeaderboardEntry *next = nullptr;
+
+    // Skip list links above the bottom level: skip[i].next is the next entry on level i + 1 and
+    // skip[i].width the number of bottom-level steps it jumps over. Empty, so never allocated, for
+    // the three entries in four that only sit on the bottom level.
+    struct SkipLink {
+        LeaderboardEntry *next;
+        size_t width;
+    };
+    vector<SkipLink> skip;
 };
 
 #endif //LEADERBOARDENTRY_H
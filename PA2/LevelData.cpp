@@ -0,0 +1,350 @@
+#include "LevelData.h"
+#include "AsteroidDash.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+shared_ptr<LevelData> LevelData::load(const string &space_grid_file_name, const string &celestial_objects_file_name,
+                                      const string &player_file_name) {
+    shared_ptr<LevelData> level = make_shared<LevelData>();
+    level->read_player(player_file_name);
+    level->read_space_grid(space_grid_file_name);
+    level->read_celestial_objects(celestial_objects_file_name);
+    return level;
+}
+
+void LevelData::build_schedule() {
+    vector<CelestialObject *> objects;
+    for (CelestialObject *current = celestial_objects_list_head; current; current = current->next_celestial_object) {
+        objects.push_back(current);
+    }
+    stable_sort(objects.begin(), objects.end(), [](const CelestialObject *a, const CelestialObject *b) {
+        return a->time_of_appearance < b->time_of_appearance;
+    });
+
+    size_t count = objects.size();
+    spawn_tick.resize(count);
+    starting_row.resize(count);
+    object_type.resize(count);
+    initial_shape_id.resize(count);
+    node.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        CelestialObject *object = objects[i];
+        object->store_index = i;
+        spawn_tick[i] = object->time_of_appearance;
+        starting_row[i] = object->starting_row;
+        object_type[i] = object->object_type;
+        initial_shape_id[i] = object->shape_id;
+        node[i] = object;
+    }
+}
+
+// Folds the bytes of one value into an FNV-1a hash
+static void hash_value(uint64_t &hash, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+}
+
+uint64_t LevelData::hash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    hash_value(hash, grid_height);
+    hash_value(hash, grid_width);
+    hash_value(hash, has_player);
+    hash_value(hash, player_row);
+    hash_value(hash, player_col);
+    for (uint64_t mask : player_masks) {
+        hash_value(hash, player_width);
+        for (int col = 0; col < player_width; ++col) hash_value(hash, mask >> col & 1);
+    }
+    for (int i = 0; i < object_count(); ++i) {
+        hash_value(hash, spawn_tick[i]);
+        hash_value(hash, starting_row[i]);
+        hash_value(hash, object_type[i]);
+        int id = initial_shape_id[i];
+        hash_value(hash, shape_arena.height(id));
+        hash_value(hash, shape_arena.width(id));
+        for (int row = 0; row < shape_arena.height(id); ++row) {
+            hash_value(hash, shape_arena.masks(id)[row]);
+        }
+    }
+    return hash;
+}
+
+// Reads a whole file into buffer with one call. Returns false if it could not be opened, its size
+// could not be found (e.g. a pipe, which cannot seek) or it could not be read in full.
+static bool read_file(const string &file_name, string &buffer) {
+    ifstream file(file_name, ios::binary);
+    if (!file.is_open()) return false;
+
+    file.seekg(0, ios::end);
+    streampos size = file.tellg();
+    if (size < 0) return false;
+    buffer.assign(static_cast<size_t>(size), '\0');
+    file.seekg(0, ios::beg);
+    return static_cast<bool>(file.read(&buffer[0], buffer.size()));
+}
+
+// Prints how long loading a file took and its throughput
+static void report_load(const string &what, const string &file_name, size_t bytes,
+                        chrono::steady_clock::time_point load_start) {
+    double elapsed_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - load_start).count();
+    cout << "Loaded " << what << " from " << file_name << " in " << elapsed_ms << " ms ("
+         << (elapsed_ms > 0 ? bytes / 1e3 / elapsed_ms : 0) << " MB/s)" << endl;
+}
+
+// Returns the next line of [pos, end) without its line break and trailing whitespace, and advances pos past it
+static void next_line(const char *&pos, const char *end, const char *&line_begin, const char *&line_end) {
+    line_begin = pos;
+    const char *newline = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    pos = newline ? newline : end;
+    line_end = pos;
+    if (pos < end) ++pos;  // Skip the '\n'
+
+    while (line_begin < line_end && (*line_begin == ' ' || *line_begin == '\t')) ++line_begin;
+    while (line_end > line_begin && (line_end[-1] == ' ' || line_end[-1] == '\t' || line_end[-1] == '\r')) --line_end;
+}
+
+// Parses the integer after the "x:" prefix of a metadata line
+static int parse_metadata_int(const char *line_begin, const char *line_end) {
+    const char *value = line_begin + 1;
+    while (value < line_end && (*value == ':' || *value == ' ')) ++value;
+    return static_cast<int>(strtol(value, nullptr, 10));
+}
+
+// Function to read the space grid from a file
+// Only the dimensions matter: the grid starts empty and is painted while playing, so the file is
+// read with one call and its cells are counted, not stored. Every row must be as wide as the first.
+bool LevelData::read_space_grid(const string &input_file) {
+    auto load_start = chrono::steady_clock::now();
+
+    string buffer;
+    if (!read_file(input_file, buffer)) {
+        cerr << "Failed to open or read space grid file." << endl;
+        return false;
+    }
+
+    const char *pos = buffer.data();
+    const char *end = pos + buffer.size();
+    const char *line_begin, *line_end;
+    int height = 0, width = 0;
+    while (pos < end) {
+        next_line(pos, end, line_begin, line_end);
+        if (line_begin == line_end) continue;
+
+        // A cell is a run of digits (with an optional sign) between blanks
+        int cells = 0;
+        bool in_cell = false;
+        for (const char *c = line_begin; c < line_end; ++c) {
+            if (*c == ' ' || *c == '\t') {
+                in_cell = false;
+            } else if ((*c >= '0' && *c <= '9') || *c == '-' || *c == '+') {
+                cells += !in_cell;
+                in_cell = true;
+            } else {
+                cerr << "Error: Unexpected character in row " << height + 1 << " of space grid file: " << input_file
+                     << endl;
+                return false;
+            }
+        }
+
+        if (height == 0) {
+            width = cells;
+        } else if (cells != width) {
+            cerr << "Error: Row " << height + 1 << " of space grid file " << input_file << " has " << cells
+                 << " cells instead of " << width << endl;
+            return false;
+        }
+        ++height;
+    }
+
+    grid_height = height;
+    grid_width = width;
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        report_load(to_string(height) + "x" + to_string(width) + " space grid", input_file, buffer.size(), load_start);
+    }
+    return true;
+}
+
+// Function to read the player from a file
+// The start row and column come first, then one line of 0s and 1s per row of the spacecraft. The
+// file is read with one call and each line is parsed straight into a row mask; the shape must be a
+// rectangle at most 64 cells wide.
+bool LevelData::read_player(const string &player_file_name) {
+    auto load_start = chrono::steady_clock::now();
+
+    string buffer;
+    if (!read_file(player_file_name, buffer)) {
+        cerr << "Error: Unable to open or read player file: " << player_file_name << endl;
+        return false;
+    }
+
+    // Read the initial position (row and column)
+    const char *pos = buffer.c_str();
+    const char *end = pos + buffer.size();
+    char *number_end;
+    long row = strtol(pos, &number_end, 10);
+    bool has_row = number_end != pos;
+    pos = number_end;
+    long col = strtol(pos, &number_end, 10);
+    if (!has_row || number_end == pos) {
+        cerr << "Error: Missing start position in player file: " << player_file_name << endl;
+        return false;
+    }
+    pos = number_end;
+
+    // Read the spacecraft shape from the subsequent lines, one row mask per line
+    vector<uint64_t> masks;
+    int width = -1;
+    bool rectangular = true;
+    const char *line_begin, *line_end;
+    while (pos < end) {
+        next_line(pos, end, line_begin, line_end);
+        if (line_begin == line_end) continue;  // Skip any empty lines
+
+        uint64_t mask = 0;
+        int cells = 0;
+        for (const char *c = line_begin; c < line_end; ++c) {
+            if (*c == '1' || *c == '0') {
+                if (*c == '1' && cells < 64) mask |= 1ULL << cells;
+                ++cells;
+            }
+        }
+        if (width < 0) width = cells;
+        rectangular = rectangular && cells == width;
+        masks.push_back(mask);
+    }
+
+    if (width <= 0 || width > 64 || !rectangular) {
+        cerr << "Error: Player file " << player_file_name << " needs a rectangular shape 1 to 64 cells wide" << endl;
+        return false;
+    }
+
+    player_row = static_cast<int>(row);
+    player_col = static_cast<int>(col);
+    player_masks = move(masks);
+    player_width = width;
+    has_player = true;
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        report_load(to_string(player_masks.size()) + "x" + to_string(width) + " player", player_file_name,
+                    buffer.size(), load_start);
+    }
+    return true;
+}
+
+// Function to read celestial objects from a file
+// The whole file is read with one call and scanned once; each object is appended at the list tail.
+bool LevelData::read_celestial_objects(const string &input_file) {
+    auto load_start = chrono::steady_clock::now();
+
+    // Check if the file opened successfully
+    string buffer;
+    if (!read_file(input_file, buffer)) {
+        cerr << "Error: Unable to open or read celestial objects file: " << input_file << endl;
+        return false;
+    }
+
+    const char *pos = buffer.data();
+    const char *end = pos + buffer.size();
+    const char *line_begin, *line_end;
+    size_t object_count = 0;
+    bool all_loaded = true;
+
+    // Reused between objects so parsing does not allocate per row once the shapes stop growing
+    vector<vector<bool>> shape;
+
+    while (pos < end) {
+        next_line(pos, end, line_begin, line_end);
+
+        // Skip empty lines and anything that does not open a shape
+        if (line_begin == line_end || (*line_begin != '[' && *line_begin != '{')) continue;
+
+        // Check if it's an object shape (either an asteroid or a power-up)
+        bool is_asteroid = (*line_begin == '[');
+        char delimiter = is_asteroid ? ']' : '}';
+
+        // Read the 2D shape matrix up to and including the row with the closing bracket
+        size_t rows = 0;
+        while (true) {
+            if (rows == shape.size()) shape.emplace_back();
+            vector<bool> &row = shape[rows++];
+            row.clear();
+            bool closed = false;
+            for (const char *c = line_begin; c < line_end; ++c) {
+                if (*c == '1') row.push_back(true);
+                else if (*c == '0') row.push_back(false);
+                else if (*c == delimiter) closed = true;
+            }
+            if (closed || pos >= end) break;
+            next_line(pos, end, line_begin, line_end);
+        }
+        shape.resize(rows);
+
+        // Read the metadata: starting row (s), tick (t), and effect (e) if applicable, up to the next blank line
+        int starting_row = -1, time_of_appearance = -1;
+        ObjectType object_type = ASTEROID;  // Default type is ASTEROID
+        while (pos < end) {
+            const char *next = pos;
+            next_line(next, end, line_begin, line_end);
+            if (line_begin == line_end || *line_begin == '[' || *line_begin == '{') break;
+            pos = next;
+
+            if (*line_begin == 's') {  // Starting row
+                starting_row = parse_metadata_int(line_begin, line_end);
+            } else if (*line_begin == 't') {  // Time of appearance
+                time_of_appearance = parse_metadata_int(line_begin, line_end);
+            } else if (*line_begin == 'e' && !is_asteroid) {  // Effect for power-ups (Life-Up or Ammo)
+                const char *effect = line_begin + 1;
+                while (effect < line_end && (*effect == ':' || *effect == ' ')) ++effect;
+                string_view value(effect, line_end - effect);
+                if (value == "life") {
+                    object_type = LIFE_UP;
+                } else if (value == "ammo") {
+                    object_type = AMMO;
+                }
+            }
+        }
+
+        // Shapes are stored as one 64-bit mask per row, so larger ones cannot be played; skip them
+        size_t shape_width = 0;
+        for (const auto &row : shape) {
+            shape_width = max(shape_width, row.size());
+        }
+        if (shape.size() > 64 || shape_width > 64) {
+            cerr << "Error: Skipped a " << shape.size() << "x" << shape_width << " celestial object in " << input_file
+                 << "; shapes can be at most 64x64 cells" << endl;
+            all_loaded = false;
+            continue;
+        }
+
+        // Create a new CelestialObject with the data read and append it to the linked list
+        CelestialObject *new_object =
+                new (node_arena) CelestialObject(shape, object_type, starting_row, time_of_appearance, shape_arena);
+        if (celestial_objects_list_tail == nullptr) {
+            celestial_objects_list_head = new_object;
+        } else {
+            celestial_objects_list_tail->next_celestial_object = new_object;
+        }
+        celestial_objects_list_tail = new_object;
+        ++object_count;
+
+        if (AsteroidDash::log_level >= LOG_DEBUG) {
+            cout << "Added object " << object_count << ": rows " << shape.size() << ", starting_row " << starting_row
+                 << ", time_of_appearance " << time_of_appearance << endl;
+        }
+    }
+
+    build_schedule();
+
+    if (AsteroidDash::log_level >= LOG_INFO) {
+        report_load(to_string(object_count) + " celestial objects", input_file, buffer.size(), load_start);
+    }
+    return all_loaded;
+}
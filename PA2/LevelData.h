@@ -0,0 +1,80 @@
+#ifndef LEVELDATA_H
+#define LEVELDATA_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CelestialObject.h"
+#include "NodeArena.h"
+#include "ShapeArena.h"
+
+using namespace std;
+
+// Everything a level is loaded from: grid size, player start, celestial objects and their shapes.
+// It never changes once loaded, so any number of games, on any number of threads, can share one
+// LevelData through a shared_ptr; per-game state lives in AsteroidDash and CelestialStore.
+class LevelData {
+public:
+    LevelData() = default;
+
+    // The celestial objects are freed with node_arena, a few blocks at once, without walking the list
+    ~LevelData() = default;
+
+    LevelData(const LevelData &) = delete;
+    LevelData &operator=(const LevelData &) = delete;
+
+    // Reads the three level files once
+    static shared_ptr<LevelData> load(const string &space_grid_file_name, const string &celestial_objects_file_name,
+                                      const string &player_file_name);
+
+    // Function to read the space grid size from a file. Returns false if the file could not be opened.
+    bool read_space_grid(const string &input_file);
+
+    // Function to read the player start position and shape from a file. Returns false if the file could not be opened.
+    bool read_player(const string &player_file_name);
+
+    // Function to read celestial objects from a file. Returns false if the file could not be opened or
+    // if objects larger than 64x64 cells had to be skipped; the other objects are loaded either way.
+    bool read_celestial_objects(const string &input_file);
+
+    // Number of celestial objects in the level
+    int object_count() const { return spawn_tick.size(); }
+
+    // 64-bit FNV-1a hash of everything that was loaded: grid size, player and every object.
+    // Replays record it so they are only played on the level they were recorded on.
+    uint64_t hash() const;
+
+    // Size of the space grid
+    int grid_height = 0;
+    int grid_width = 0;
+
+    // Player start; the spacecraft as one mask per row (bit j = column j)
+    bool has_player = false;
+    vector<uint64_t> player_masks;
+    int player_width = 0;
+    int player_row = 0;
+    int player_col = 0;
+
+    // Celestial objects as loaded, in file order. The nodes live in node_arena.
+    NodeArena<CelestialObject> node_arena;
+    CelestialObject *celestial_objects_list_head = nullptr;
+    CelestialObject *celestial_objects_list_tail = nullptr;
+
+    // Every celestial object shape of the level with its rotations, shared between identical objects
+    ShapeArena shape_arena;
+
+    // The objects ordered by time of appearance (file order on ties); index i is store index i
+    vector<int> spawn_tick;          // time_of_appearance
+    vector<int> starting_row;
+    vector<uint8_t> object_type;     // ObjectType
+    vector<int> initial_shape_id;    // Unrotated shape in shape_arena
+    vector<CelestialObject *> node;  // Matching node of the linked list
+
+private:
+    // Fills the schedule columns from the linked list and sets each node's store_index
+    void build_schedule();
+};
+
+#endif // LEVELDATA_H
@@ -0,0 +1,53 @@
+#ifndef NODEARENA_H
+#define NODEARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// First block a NodeArena allocates, in nodes
+#define NODE_ARENA_FIRST_BLOCK 64
+
+// Largest block a NodeArena allocates, in nodes
+#define NODE_ARENA_MAX_BLOCK 65536
+
+// Typed bump allocator for nodes that all die with their owner, used through placement new:
+// new (arena) T(...). Nodes are carved out of blocks that double in size up to NODE_ARENA_MAX_BLOCK
+// nodes and are never freed one by one; destroying the arena frees every block at once without
+// visiting the nodes, so T must be trivially destructible. Not thread-safe: one owner fills it.
+template<typename T>
+class NodeArena {
+    static_assert(is_trivially_destructible<T>::value, "NodeArena never runs node destructors");
+
+public:
+    NodeArena() = default;
+    NodeArena(const NodeArena &) = delete;
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    void *allocate() {
+        if (block_used == block_size) {
+            block_size = block_size ? min<size_t>(2 * block_size, NODE_ARENA_MAX_BLOCK) : NODE_ARENA_FIRST_BLOCK;
+            blocks.emplace_back(new Slot[block_size]);
+            block_used = 0;
+        }
+        return blocks.back()[block_used++].storage;
+    }
+
+    // Number of heap blocks the nodes occupy
+    size_t block_count() const { return blocks.size(); }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    vector<unique_ptr<Slot[]>> blocks;
+    size_t block_size = 0;  // Nodes in the last block
+    size_t block_used = 0;  // Nodes of the last block handed out
+};
+
+#endif // NODEARENA_H
@@ -0,0 +1,128 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+// Nodes a thread takes from / gives back to the shared pool at a time
+#define NODE_POOL_BATCH 64
+
+// Largest block the shared pool allocates, in nodes
+#define NODE_POOL_MAX_BLOCK 65536
+
+// Typed pool allocator for list nodes, used through a class's operator new / operator delete.
+// Nodes are carved out of blocks that double in size up to NODE_POOL_MAX_BLOCK nodes, so the nodes
+// themselves cost one heap allocation per block rather than one each; members that own memory
+// (strings, vectors) still allocate on their own. Freed nodes go on a per-thread free list and are reused by the next allocation;
+// threads exchange nodes with the shared pool in batches, so the shared lock is rarely taken.
+// Blocks are only returned to the system at exit.
+template<typename T>
+class NodePool {
+public:
+    static void *allocate() {
+        LocalCache &cache = local();
+        if (!cache.free_list) refill(cache);
+        FreeNode *node = cache.free_list;
+        cache.free_list = node->next;
+        --cache.count;
+        return node;
+    }
+
+    static void deallocate(void *pointer) {
+        LocalCache &cache = local();
+        FreeNode *node = static_cast<FreeNode *>(pointer);
+        node->next = cache.free_list;
+        cache.free_list = node;
+        ++cache.count;
+
+        // Do not let one thread hoard what others allocate
+        if (cache.count >= 2 * NODE_POOL_BATCH) {
+            FreeNode *batch = cache.free_list, *last = batch;
+            for (int i = 1; i < NODE_POOL_BATCH; ++i) last = last->next;
+            cache.free_list = last->next;
+            cache.count -= NODE_POOL_BATCH;
+            give_back(batch, last);
+        }
+    }
+
+private:
+    struct FreeNode {
+        FreeNode *next;
+    };
+
+    union Slot {
+        FreeNode free;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Shared {
+        mutex lock;
+        FreeNode *free_list = nullptr;
+        vector<unique_ptr<Slot[]>> blocks;
+        size_t block_size = 0;  // Nodes in the last block
+        size_t block_used = 0;  // Nodes of the last block handed out
+    };
+
+    // Each thread's free nodes, given back to the shared pool when the thread exits
+    struct LocalCache {
+        FreeNode *free_list = nullptr;
+        size_t count = 0;
+
+        ~LocalCache() {
+            if (!free_list) return;
+            FreeNode *last = free_list;
+            while (last->next) last = last->next;
+            give_back(free_list, last);
+        }
+    };
+
+    static Shared &shared() {
+        static Shared pool;
+        return pool;
+    }
+
+    static LocalCache &local() {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+
+    // Moves up to NODE_POOL_BATCH nodes into the thread's free list
+    static void refill(LocalCache &cache) {
+        Shared &pool = shared();
+        lock_guard<mutex> guard(pool.lock);
+        for (int i = 0; i < NODE_POOL_BATCH; ++i) {
+            FreeNode *node;
+            if (pool.free_list) {
+                node = pool.free_list;
+                pool.free_list = node->next;
+            } else {
+                if (pool.block_used == pool.block_size) {
+                    pool.block_size = pool.block_size ? min<size_t>(2 * pool.block_size, NODE_POOL_MAX_BLOCK)
+                                                      : NODE_POOL_BATCH;
+                    pool.blocks.emplace_back(new Slot[pool.block_size]);
+                    pool.block_used = 0;
+                }
+                node = &pool.blocks.back()[pool.block_used++].free;
+            }
+            node->next = cache.free_list;
+            cache.free_list = node;
+            ++cache.count;
+        }
+    }
+
+    // Returns the chain first..last to the shared pool
+    static void give_back(FreeNode *first, FreeNode *last) {
+        Shared &pool = shared();
+        lock_guard<mutex> guard(pool.lock);
+        last->next = pool.free_list;
+        pool.free_list = first;
+    }
+};
+
+#endif // NODEPOOL_H
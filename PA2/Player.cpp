@@ -1,12 +1,25 @@
 #include "Player.h"
+#include "SpaceGrid.h"
 
 // Constructor to initialize the player's spacecraft, position, and ammo
 Player::Player(const vector<vector<bool>> &shape, int row, int col, const string &player_name, int max_ammo, int lives)
-        : spacecraft_shape(shape), position_row(row), position_col(col), player_name(player_name), max_ammo(max_ammo),
+        : spacecraft_shape(shape), shape_masks(SpaceGrid::to_row_masks(shape)), position_row(row), position_col(col), player_name(player_name), max_ammo(max_ammo),
           current_ammo(max_ammo), lives(lives) {
     // Player is initialized with full ammo and the given number of lives
 }
 
+Player::Player(const vector<uint64_t> &masks, int width, int row, int col, const string &player_name, int max_ammo,
+               int lives)
+        : spacecraft_shape(masks.size(), vector<bool>(width)), shape_masks(masks), position_row(row), position_col(col),
+          player_name(player_name), max_ammo(max_ammo), current_ammo(max_ammo), lives(lives) {
+    // spacecraft_shape is the boolean view of the masks
+    for (size_t i = 0; i < masks.size(); ++i) {
+        for (int j = 0; j < width; ++j) {
+            spacecraft_shape[i][j] = masks[i] >> j & 1;
+        }
+    }
+}
+
 // Move player left within the grid boundaries
 void Player::move_left() {
     if (position_col > 0) {
@@ -1,6 +1,7 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -11,6 +12,9 @@ public:
     // Player's spacecraft shape
     vector<vector<bool>> spacecraft_shape;
 
+    // Spacecraft shape as one bit mask per row (bit j = column j), used for grid placement and collisions
+    vector<uint64_t> shape_masks;
+
     // Row where the top-left of the spacecraft is located
     int position_row;
 
@@ -33,6 +37,10 @@ public:
     Player(const vector<vector<bool>> &shape, int row, int col, const string &player_name, int max_ammo = 10,
            int lives = 3);
 
+    // Constructor from a shape given as one mask per row, width cells wide, as the level loads it
+    Player(const vector<uint64_t> &masks, int width, int row, int col, const string &player_name, int max_ammo = 10,
+           int lives = 3);
+
     // Move player in the space grid
     void move_left();
 
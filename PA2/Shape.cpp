@@ -0,0 +1,21 @@
+#include "Shape.h"
+#include <array>
+#include <utility>
+
+template<int W, int H>
+static void rotate_kernel(const uint64_t *in, uint64_t *out) {
+    Shape<W, H>::from_rows(in).rotated_clockwise().to_rows(out);
+}
+
+// Kernel for height h and width w at index 8 * (h - 1) + (w - 1)
+template<size_t... I>
+static constexpr array<RotateKernel, 64> make_rotate_kernels(index_sequence<I...>) {
+    return {{&rotate_kernel<I % 8 + 1, I / 8 + 1>...}};
+}
+
+static constexpr array<RotateKernel, 64> rotate_kernels = make_rotate_kernels(make_index_sequence<64>());
+
+RotateKernel find_rotate_kernel(int height, int width) {
+    if (height < 1 || height > 8 || width < 1 || width > 8) return nullptr;
+    return rotate_kernels[8 * (height - 1) + (width - 1)];
+}
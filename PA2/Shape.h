@@ -0,0 +1,74 @@
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include <cstdint>
+
+using namespace std;
+
+// Bit tricks on an 8x8 board packed into a uint64_t, one byte per row (bit 8 * r + c = cell (r, c))
+namespace board8 {
+    // Every byte set to the same value
+    constexpr uint64_t repeat_byte(uint64_t byte) { return byte * 0x0101010101010101ULL; }
+
+    // Reverses the order of the rows
+    constexpr uint64_t flip_vertical(uint64_t bits) { return __builtin_bswap64(bits); }
+
+    // Swaps rows and columns: cell (r, c) moves to (c, r)
+    constexpr uint64_t transpose(uint64_t bits) {
+        uint64_t t = 0x0F0F0F0F00000000ULL & (bits ^ (bits << 28));
+        bits ^= t ^ (t >> 28);
+        t = 0x3333000033330000ULL & (bits ^ (bits << 14));
+        bits ^= t ^ (t >> 14);
+        t = 0x5500550055005500ULL & (bits ^ (bits << 7));
+        bits ^= t ^ (t >> 7);
+        return bits;
+    }
+}
+
+// A W x H shape (at most 8 x 8) in a single uint64_t laid out as a board8 board, top-left aligned.
+// Sizes are template parameters, so rotation compiles to a handful of word operations.
+template<int W, int H>
+struct Shape {
+    static_assert(W >= 1 && W <= 8 && H >= 1 && H <= 8, "Shape holds at most 8x8 cells");
+
+    static constexpr int width = W;
+    static constexpr int height = H;
+
+    uint64_t bits = 0;
+
+    // Packs H row masks (bit c = column c)
+    static constexpr Shape from_rows(const uint64_t *rows) {
+        Shape shape;
+        for (int r = 0; r < H; ++r) {
+            shape.bits |= (rows[r] & ((1ULL << W) - 1)) << (8 * r);
+        }
+        return shape;
+    }
+
+    // Unpacks into H row masks
+    constexpr void to_rows(uint64_t *rows) const {
+        for (int r = 0; r < H; ++r) {
+            rows[r] = (bits >> (8 * r)) & 0xFF;
+        }
+    }
+
+    constexpr bool cell(int row, int col) const { return (bits >> (8 * row + col)) & 1; }
+
+    // The shape turned 90 degrees clockwise: cell (r, c) of the result is cell (H - 1 - c, r)
+    constexpr Shape<H, W> rotated_clockwise() const {
+        // On the full board the turned shape ends up against the right edge; move it back to column 0
+        uint64_t turned = board8::transpose(board8::flip_vertical(bits)) >> (8 - H);
+        return Shape<H, W>{turned & board8::repeat_byte((1u << H) - 1)};
+    }
+};
+
+// Turns a shape given as row masks 90 degrees clockwise. in and out may be the same buffer.
+typedef void (*RotateKernel)(const uint64_t *in, uint64_t *out);
+
+// The Shape<width, height> rotation for shapes up to 8x8, nullptr for larger ones
+RotateKernel find_rotate_kernel(int height, int width);
+
+// Rotating the L-tromino {11, 01} of ShapeArena's convention gives {11, 10, 00}
+static_assert(Shape<3, 2>{0x0103}.rotated_clockwise().bits == 0x000203, "Shape rotation");
+
+#endif // SHAPE_H
@@ -0,0 +1,80 @@
+#include "ShapeArena.h"
+#include <algorithm>
+#include <stdexcept>
+
+// FNV-1a over the width and the row masks
+static uint64_t hash_shape(const vector<uint64_t> &masks, int width) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(width);
+    mix(masks.size());
+    for (uint64_t mask : masks) mix(mask);
+    return hash;
+}
+
+int ShapeArena::add(const vector<uint64_t> &masks, int width) {
+    if (masks.size() > 64 || width > 64) {
+        throw invalid_argument("Shapes larger than 64x64 cells are not supported");
+    }
+
+    // Reuse an identical shape if one is already stored
+    uint64_t hash = hash_shape(masks, width);
+    auto range = index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        int id = it->second;
+        if (shapes[id].width == width && shapes[id].height == masks.size() &&
+            equal(masks.begin(), masks.end(), this->masks(id))) {
+            return id;
+        }
+    }
+
+    // Otherwise store the shape followed by its three clockwise rotations
+    int id = append(masks, width);
+    vector<uint64_t> rotated = masks;
+    rotated.resize(max<size_t>(masks.size(), width), 0);
+    for (int r = 1; r < 4; ++r) {
+        int previous = id + r - 1;
+        rotate_clockwise(previous, rotated.data());
+        append(vector<uint64_t>(rotated.begin(), rotated.begin() + shapes[previous].width), shapes[previous].height);
+    }
+    index.emplace(hash, id);
+    return id;
+}
+
+int ShapeArena::append(const vector<uint64_t> &masks, int width) {
+    ShapeInfo info;
+    info.offset = words.size();
+    info.height = masks.size();
+    info.width = width;
+    words.insert(words.end(), masks.begin(), masks.end());
+    shapes.push_back(info);
+    return shapes.size() - 1;
+}
+
+void ShapeArena::rotate_clockwise(int shape_id, uint64_t *masks) const {
+    int height = shapes[shape_id].height, width = shapes[shape_id].width;
+    if (RotateKernel kernel = find_rotate_kernel(height, width)) {
+        kernel(masks, masks);
+        return;
+    }
+    vector<uint64_t> rotated = rotate_masks_clockwise(masks, height, width);
+    copy(rotated.begin(), rotated.end(), masks);
+}
+
+vector<uint64_t> ShapeArena::rotate_masks_clockwise(const uint64_t *masks, int height, int width) {
+    // Cell (r, c) of the result is cell (height - 1 - c, r) of the original
+    vector<uint64_t> rotated(width, 0);
+    for (int r = 0; r < width; ++r) {
+        for (int c = 0; c < height; ++c) {
+            if ((masks[height - 1 - c] >> r) & 1) {
+                rotated[r] |= 1ULL << c;
+            }
+        }
+    }
+    return rotated;
+}
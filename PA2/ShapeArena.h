@@ -0,0 +1,57 @@
+#ifndef SHAPEARENA_H
+#define SHAPEARENA_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Shape.h"
+
+using namespace std;
+
+// Flat storage for every shape of a level and all of its rotations.
+// Each distinct shape is registered once as a rotation set of four consecutive shape ids
+// (0, 90, 180 and 270 degrees clockwise), so rotating is an index increment and identical
+// shapes loaded for different objects share a single set.
+class ShapeArena {
+public:
+    // Registers a shape given as one mask per row and returns the id of its unrotated form.
+    // Returns the existing id if an identical shape was registered before.
+    int add(const vector<uint64_t> &masks, int width);
+
+    // Row masks of a shape (bit j = column j)
+    const uint64_t *masks(int shape_id) const { return &words[shapes[shape_id].offset]; }
+
+    int height(int shape_id) const { return shapes[shape_id].height; }
+    int width(int shape_id) const { return shapes[shape_id].width; }
+
+    // Number of shape ids in the arena (four per distinct shape)
+    int size() const { return shapes.size(); }
+
+    // The same shape turned 90 degrees clockwise / counter-clockwise
+    static int rotate_right(int shape_id) { return (shape_id & ~3) | ((shape_id + 1) & 3); }
+    static int rotate_left(int shape_id) { return (shape_id & ~3) | ((shape_id + 3) & 3); }
+
+    // Turns a height x width shape 90 degrees clockwise into a width x height shape; works for any size
+    static vector<uint64_t> rotate_masks_clockwise(const uint64_t *masks, int height, int width);
+
+private:
+    struct ShapeInfo {
+        uint32_t offset;  // Index of the first row mask in words
+        uint16_t height;
+        uint16_t width;
+    };
+
+    // Appends one shape to the arena and returns its id
+    int append(const vector<uint64_t> &masks, int width);
+
+    // Turns the row masks of a shape with this id's size 90 degrees clockwise, in place.
+    // Shapes up to 8x8 use their Shape<W, H> kernel; larger ones take the generic path.
+    void rotate_clockwise(int shape_id, uint64_t *masks) const;
+
+    vector<uint64_t> words;     // Row masks of every shape, back to back
+    vector<ShapeInfo> shapes;   // Indexed by shape id
+    unordered_multimap<uint64_t, int> index;  // Hash of (width, masks) -> unrotated shape id
+};
+
+#endif // SHAPEARENA_H
@@ -0,0 +1,188 @@
+#include "SpaceGrid.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+SpaceGrid::SpaceGrid(int height, int width) {
+    resize(height, width);
+}
+
+void SpaceGrid::resize(int height, int width) {
+    release_all();
+    this->height = height;
+    this->width = width;
+    tile_rows = (height + GRID_TILE_SIZE - 1) / GRID_TILE_SIZE;
+    tile_cols = (width + 63) / 64;
+    last_word_mask = (width % 64 == 0) ? ~0ULL : ((1ULL << (width % 64)) - 1);
+    tiles.assign(static_cast<size_t>(tile_rows) * tile_cols, nullptr);
+}
+
+int SpaceGrid::get_cell(int row, int col) const {
+    const Tile *tile = tiles[tile_index(row, col >> 6)];
+    if (!tile) return 0;
+    uint64_t bit = 1ULL << (col & 63);
+    if (tile->rows[OBJECT_PLANE][row % GRID_TILE_SIZE] & bit) return 2;
+    if (tile->rows[PLAYER_PLANE][row % GRID_TILE_SIZE] & bit) return 1;
+    return 0;
+}
+
+void SpaceGrid::clear() {
+    release_all();
+}
+
+void SpaceGrid::clear_plane(GridPlane plane) {
+    // Backwards, since releasing a tile moves the last one into its slot
+    for (size_t i = allocated.size(); i-- > 0;) {
+        Tile *tile = allocated[i];
+        memset(tile->rows[plane], 0, sizeof(tile->rows[plane]));
+        tile->used_rows[plane] = 0;
+        release_if_empty(tile);
+    }
+}
+
+void SpaceGrid::clear_row(GridPlane plane, int row) {
+    // On wide, sparse grids the allocated list is shorter than the row. Walked backwards, since
+    // releasing a tile moves the last one into its slot.
+    if (allocated.size() < static_cast<size_t>(tile_cols)) {
+        size_t tile_row = row / GRID_TILE_SIZE;
+        for (size_t i = allocated.size(); i-- > 0;) {
+            size_t index = allocated[i]->index;
+            if (index / tile_cols == tile_row) clear_bits(plane, row, index % tile_cols, ~0ULL);
+        }
+        return;
+    }
+    for (int word = 0; word < tile_cols; ++word) {
+        Tile *tile = tiles[tile_index(row, word)];
+        if (tile) clear_bits(plane, row, word, ~0ULL);
+    }
+}
+
+SpaceGrid::Tile *SpaceGrid::acquire_tile(size_t index) {
+    Tile *tile;
+    if (!free_tiles.empty()) {
+        tile = free_tiles.back();
+        free_tiles.pop_back();
+    } else {
+        tile_storage.emplace_back(new Tile());
+        tile = tile_storage.back().get();
+    }
+    memset(tile->rows, 0, sizeof(tile->rows));
+    tile->used_rows[PLAYER_PLANE] = tile->used_rows[OBJECT_PLANE] = 0;
+    tile->index = index;
+    tile->slot = allocated.size();
+    allocated.push_back(tile);
+    tiles[index] = tile;
+    return tile;
+}
+
+void SpaceGrid::release_if_empty(Tile *tile) {
+    if (tile->used_rows[PLAYER_PLANE] | tile->used_rows[OBJECT_PLANE]) return;
+    tiles[tile->index] = nullptr;
+    allocated[tile->slot] = allocated.back();
+    allocated[tile->slot]->slot = tile->slot;
+    allocated.pop_back();
+    free_tiles.push_back(tile);
+}
+
+void SpaceGrid::release_all() {
+    for (Tile *tile : allocated) {
+        tiles[tile->index] = nullptr;
+        free_tiles.push_back(tile);
+    }
+    allocated.clear();
+}
+
+void SpaceGrid::set_bits(GridPlane plane, int row, int word, uint64_t bits) {
+    size_t index = tile_index(row, word);
+    Tile *tile = tiles[index] ? tiles[index] : acquire_tile(index);
+    int r = row % GRID_TILE_SIZE;
+    tile->rows[plane][r] |= bits;
+    tile->used_rows[plane] |= 1ULL << r;
+}
+
+void SpaceGrid::clear_bits(GridPlane plane, int row, int word, uint64_t bits) {
+    Tile *tile = tiles[tile_index(row, word)];
+    if (!tile) return;
+    int r = row % GRID_TILE_SIZE;
+    tile->rows[plane][r] &= ~bits;
+    if (tile->rows[plane][r] == 0) {
+        tile->used_rows[plane] &= ~(1ULL << r);
+        release_if_empty(tile);
+    }
+}
+
+bool SpaceGrid::place(int col, uint64_t mask, int &word, uint64_t &low, uint64_t &high) const {
+    if (mask == 0 || col >= width || col <= -64) return false;
+
+    if (col >= 0) {
+        int offset = col & 63;
+        word = col >> 6;
+        low = mask << offset;
+        high = offset ? (mask >> (64 - offset)) : 0;
+    } else {
+        // Shape sticks out of the left edge; drop the columns before 0
+        word = 0;
+        low = mask >> -col;
+        high = 0;
+    }
+
+    // Drop the columns past the right edge
+    if (word == tile_cols - 1) {
+        low &= last_word_mask;
+        high = 0;
+    } else if (word + 1 == tile_cols - 1) {
+        high &= last_word_mask;
+    }
+    return (low | high) != 0;
+}
+
+void SpaceGrid::stamp(GridPlane plane, int row, int col, const uint64_t *masks, int mask_rows) {
+    int first = max(0, -row), last = min(mask_rows, height - row);
+    for (int i = first; i < last; ++i) {
+        int word;
+        uint64_t low, high;
+        if (!place(col, masks[i], word, low, high)) continue;
+        if (low) set_bits(plane, row + i, word, low);
+        if (high) set_bits(plane, row + i, word + 1, high);
+    }
+}
+
+void SpaceGrid::erase(GridPlane plane, int row, int col, const uint64_t *masks, int mask_rows) {
+    int first = max(0, -row), last = min(mask_rows, height - row);
+    for (int i = first; i < last; ++i) {
+        int word;
+        uint64_t low, high;
+        if (!place(col, masks[i], word, low, high)) continue;
+        if (low) clear_bits(plane, row + i, word, low);
+        if (high) clear_bits(plane, row + i, word + 1, high);
+    }
+}
+
+bool SpaceGrid::overlaps(GridPlane plane, int row, int col, const uint64_t *masks, int mask_rows) const {
+    int first = max(0, -row), last = min(mask_rows, height - row);
+    for (int i = first; i < last; ++i) {
+        int word;
+        uint64_t low, high;
+        if (!place(col, masks[i], word, low, high)) continue;
+        if ((row_word(plane, row + i, word) & low) || (high && (row_word(plane, row + i, word + 1) & high))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+vector<uint64_t> SpaceGrid::to_row_masks(const vector<vector<bool>> &shape) {
+    vector<uint64_t> masks;
+    masks.reserve(shape.size());
+    for (const auto &row : shape) {
+        if (row.size() > 64) {
+            throw invalid_argument("Shapes wider than 64 cells are not supported");
+        }
+        uint64_t mask = 0;
+        for (size_t j = 0; j < row.size(); ++j) {
+            if (row[j]) mask |= 1ULL << j;
+        }
+        masks.push_back(mask);
+    }
+    return masks;
+}
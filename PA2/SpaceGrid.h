@@ -0,0 +1,127 @@
+#ifndef SPACEGRID_H
+#define SPACEGRID_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Layers of the space grid; each one is a separate bitboard so the player and
+// celestial objects can be tested against each other with word-wide AND operations
+enum GridPlane {
+    PLAYER_PLANE = 0,
+    OBJECT_PLANE = 1
+};
+
+// Rows and columns of one SpaceGrid tile; a tile row of one plane is a single 64-bit word
+#define GRID_TILE_SIZE 64
+
+// Bit-packed, sparse space grid. The grid is cut into GRID_TILE_SIZE x GRID_TILE_SIZE tiles that are
+// only allocated while something is drawn in them, so memory follows the occupied area rather than
+// the grid size, and every operation only visits the tiles it touches. Within a tile, row r of a
+// plane is one word, bit j being column 64 * tile_col + j; word w of a grid row is therefore tile
+// column w. Shapes are passed as one uint64_t mask per shape row (bit j = shape column j).
+class SpaceGrid {
+public:
+    SpaceGrid() = default;
+
+    // Creates an empty grid with the given dimensions
+    SpaceGrid(int height, int width);
+
+    // Resizes the grid and clears every cell
+    void resize(int height, int width);
+
+    int get_height() const { return height; }
+    int get_width() const { return width; }
+    int get_words_per_row() const { return tile_cols; }
+
+    // Number of tiles down and across the grid
+    int get_tile_rows() const { return tile_rows; }
+    int get_tile_cols() const { return tile_cols; }
+
+    // Tiles currently allocated
+    size_t allocated_tiles() const { return allocated.size(); }
+
+    // Table index (tile_row * tile_cols + tile_col) of the i-th allocated tile, i < allocated_tiles()
+    size_t allocated_tile(size_t i) const { return allocated[i]->index; }
+
+    // Returns 0 for an empty cell, 1 for a player cell, 2 for a celestial object cell. Objects are
+    // painted over the player, so a cell in both planes is an object cell.
+    int get_cell(int row, int col) const;
+
+    // Clears every cell of every plane
+    void clear();
+
+    // Clears every cell of one plane
+    void clear_plane(GridPlane plane);
+
+    // Clears one row of a plane
+    void clear_row(GridPlane plane, int row);
+
+    // ORs a shape into the plane with its top-left corner at (row, col); cells outside the grid are dropped
+    void stamp(GridPlane plane, int row, int col, const uint64_t *masks, int mask_rows);
+
+    // Clears the cells of a shape placed at (row, col) from the plane
+    void erase(GridPlane plane, int row, int col, const uint64_t *masks, int mask_rows);
+
+    // True if any cell of the shape placed at (row, col) is already set in the plane
+    bool overlaps(GridPlane plane, int row, int col, const uint64_t *masks, int mask_rows) const;
+
+    // Word w of a row of a plane (columns 64 * w to 64 * w + 63)
+    uint64_t row_word(GridPlane plane, int row, int word) const {
+        const Tile *tile = tiles[tile_index(row, word)];
+        return tile ? tile->rows[plane][row % GRID_TILE_SIZE] : 0;
+    }
+
+    // The GRID_TILE_SIZE row words of one plane of a tile, or nullptr if the tile is empty
+    const uint64_t *tile_words(GridPlane plane, int tile_row, int tile_col) const {
+        const Tile *tile = tiles[static_cast<size_t>(tile_row) * tile_cols + tile_col];
+        return tile ? tile->rows[plane] : nullptr;
+    }
+
+    // Converts a boolean shape into per-row masks; throws invalid_argument for rows wider than 64 cells
+    static vector<uint64_t> to_row_masks(const vector<vector<bool>> &shape);
+
+private:
+    struct Tile {
+        uint64_t rows[2][GRID_TILE_SIZE];
+        uint64_t used_rows[2];  // Bit r set while row r of the plane is not empty
+        size_t index;           // Position in the tile table
+        size_t slot;            // Position in the allocated list
+    };
+
+    size_t tile_index(int row, int word) const {
+        return static_cast<size_t>(row / GRID_TILE_SIZE) * tile_cols + word;
+    }
+
+    // Shifts a row mask to column col, splitting it across the (at most two) words it touches.
+    // Returns false if no part of the mask lands inside the grid.
+    bool place(int col, uint64_t mask, int &word, uint64_t &low, uint64_t &high) const;
+
+    // Sets / clears bits of one row word, allocating or releasing its tile as needed
+    void set_bits(GridPlane plane, int row, int word, uint64_t bits);
+    void clear_bits(GridPlane plane, int row, int word, uint64_t bits);
+
+    // Allocates the empty tile at a table index, reusing released tiles first
+    Tile *acquire_tile(size_t index);
+
+    // Gives the tile back once both of its planes are empty
+    void release_if_empty(Tile *tile);
+
+    // Gives back every tile
+    void release_all();
+
+    int height = 0;
+    int width = 0;
+    int tile_rows = 0;
+    int tile_cols = 0;
+    uint64_t last_word_mask = 0;  // Valid bits of the last word of every row
+
+    vector<Tile *> tiles;                 // Row-major tile table, nullptr for empty tiles
+    vector<Tile *> allocated;             // The allocated tiles, in no particular order
+    vector<unique_ptr<Tile>> tile_storage;  // Every tile ever allocated
+    vector<Tile *> free_tiles;            // Released tiles, ready for reuse
+};
+
+#endif // SPACEGRID_H
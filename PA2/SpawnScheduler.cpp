@@ -0,0 +1,13 @@
+#include "SpawnScheduler.h"
+
+void SpawnScheduler::promote(unsigned long tick, const LevelData &level, vector<int> &active) {
+    while (next_pending < level.object_count() &&
+           (level.spawn_tick[next_pending] < 0 || static_cast<unsigned long>(level.spawn_tick[next_pending]) <= tick)) {
+        active.push_back(next_pending++);
+    }
+}
+
+unsigned long SpawnScheduler::next_spawn_time(const LevelData &level) const {
+    int time = level.spawn_tick[next_pending];
+    return time < 0 ? 0 : static_cast<unsigned long>(time);
+}
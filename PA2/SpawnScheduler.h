@@ -0,0 +1,37 @@
+#ifndef SPAWNSCHEDULER_H
+#define SPAWNSCHEDULER_H
+
+#include <vector>
+
+#include "LevelData.h"
+
+using namespace std;
+
+// Queue of celestial objects that have not appeared yet. The LevelData schedule is ordered by
+// time of appearance, so the queue is a cursor into it; each object is handed over to the
+// caller's active set exactly once, when its tick comes.
+class SpawnScheduler {
+public:
+    // Appends the index of every pending object with time_of_appearance <= tick to active
+    void promote(unsigned long tick, const LevelData &level, vector<int> &active);
+
+    // True if some objects have not appeared yet
+    bool has_pending(const LevelData &level) const { return next_pending < level.object_count(); }
+
+    // Time of appearance of the next pending object; only valid if has_pending()
+    unsigned long next_spawn_time(const LevelData &level) const;
+
+    // Makes every object pending again
+    void reset() { next_pending = 0; }
+
+    // Index of the next pending object; every object before it has been promoted
+    int position() const { return next_pending; }
+
+    // Makes the objects from index position on pending again, as they were when position() returned it
+    void rewind(int position) { next_pending = position; }
+
+private:
+    int next_pending = 0;
+};
+
+#endif // SPAWNSCHEDULER_H
@@ -0,0 +1,63 @@
+#include "TickProfiler.h"
+#include <chrono>
+#include <iomanip>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static const char *phase_names[PHASE_COUNT] = {"parse", "move", "shoot", "update", "render", "fast_forward"};
+
+void PhaseHistogram::record(uint64_t duration) {
+    int bucket = duration ? 63 - __builtin_clzll(duration) : 0;
+    ++buckets[bucket];
+    ++count;
+    total += duration;
+    if (duration > max) max = duration;
+}
+
+uint64_t PhaseHistogram::quantile(double q) const {
+    if (count == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(q * (count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < PROFILE_BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= target) {
+            uint64_t upper = bucket == 63 ? UINT64_MAX : (2ULL << bucket) - 1;
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+TickProfiler &TickProfiler::local() {
+    static thread_local TickProfiler profiler;
+    return profiler;
+}
+
+uint64_t TickProfiler::now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void TickProfiler::print_summary(ostream &out) const {
+    out << "Tick profile (cycles; percentiles are log2 bucket upper bounds)" << endl;
+    out << left << setw(14) << "phase" << right << setw(12) << "count" << setw(12) << "mean" << setw(12) << "p50"
+        << setw(12) << "p99" << setw(14) << "max" << endl;
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        const PhaseHistogram &histogram = phases[phase];
+        if (histogram.count == 0) continue;
+        out << left << setw(14) << phase_names[phase] << right << setw(12) << histogram.count << setw(12)
+            << histogram.total / histogram.count << setw(12) << histogram.quantile(0.5) << setw(12)
+            << histogram.quantile(0.99) << setw(14) << histogram.max << endl;
+    }
+}
+
+void TickProfiler::clear() {
+    for (PhaseHistogram &histogram : phases) {
+        histogram = PhaseHistogram();
+    }
+}
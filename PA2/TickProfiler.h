@@ -0,0 +1,84 @@
+#ifndef TICKPROFILER_H
+#define TICKPROFILER_H
+
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+
+// Parts of a game tick that are timed separately
+enum TickPhase {
+    PHASE_PARSE = 0,         // Reading the commands file
+    PHASE_MOVE = 1,          // Player movement
+    PHASE_SHOOT = 2,         // shoot()
+    PHASE_UPDATE = 3,        // update_space_grid()
+    PHASE_RENDER = 4,        // Drawing the grid
+    PHASE_FAST_FORWARD = 5,  // fast_forward() over a run of NOPs, including the ticks it steps through
+    PHASE_COUNT = 6
+};
+
+// Buckets of a PhaseHistogram; bucket b counts durations in [2^b, 2^(b+1)) ticks of the clock
+#define PROFILE_BUCKETS 64
+
+// Log2 histogram of the durations of one phase
+struct PhaseHistogram {
+    uint64_t buckets[PROFILE_BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+
+    void record(uint64_t duration);
+
+    // Upper bound of the bucket holding the given quantile (0..1) of the durations
+    uint64_t quantile(double q) const;
+};
+
+// Per-thread timing of tick phases. Built in only when ASTEROIDDASH_PROFILE is defined; otherwise
+// PROFILE_PHASE expands to nothing and the game loop carries no instrumentation at all.
+// A run starts with PROFILE_RESET, so its PROFILE_SUMMARY only covers that run.
+class TickProfiler {
+public:
+    // The calling thread's profiler
+    static TickProfiler &local();
+
+    // Current value of the cycle counter (the TSC on x86, nanoseconds elsewhere)
+    static uint64_t now();
+
+    void record(TickPhase phase, uint64_t duration) { phases[phase].record(duration); }
+
+    // Prints count, mean, p50, p99 and max of every phase that ran
+    void print_summary(ostream &out = cout) const;
+
+    // Forgets everything recorded so far
+    void clear();
+
+    PhaseHistogram phases[PHASE_COUNT];
+};
+
+// Times the rest of the enclosing block as one occurrence of a phase
+class ProfileScope {
+public:
+    explicit ProfileScope(TickPhase phase) : phase(phase), start(TickProfiler::now()) {}
+    ~ProfileScope() { TickProfiler::local().record(phase, TickProfiler::now() - start); }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    TickPhase phase;
+    uint64_t start;
+};
+
+#ifdef ASTEROIDDASH_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_PHASE(phase) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(phase)
+#define PROFILE_RESET() TickProfiler::local().clear()
+#define PROFILE_SUMMARY() TickProfiler::local().print_summary()
+#else
+#define PROFILE_PHASE(phase) ((void) 0)
+#define PROFILE_RESET() ((void) 0)
+#define PROFILE_SUMMARY() ((void) 0)
+#endif
+
+#endif // TICKPROFILER_H
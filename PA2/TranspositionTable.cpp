@@ -0,0 +1,74 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+
+// Set in the data of every used slot, so a used slot is never all zeroes
+#define TRANSPOSITION_USED (1ULL << 63)
+
+TranspositionTable::TranspositionTable(size_t capacity) {
+    size_t bucket_count = 1;
+    while (bucket_count * 2 * TRANSPOSITION_BUCKET_SIZE <= capacity) {
+        bucket_count *= 2;
+    }
+    buckets.reset(new Bucket[bucket_count]);
+    bucket_mask = bucket_count - 1;
+}
+
+uint64_t TranspositionTable::pack(long value, int depth) {
+    long clamped = max<long>(INT32_MIN, min<long>(INT32_MAX, value));
+    uint64_t packed_depth = max(0, min(depth, 0x7FFF));
+    return TRANSPOSITION_USED | packed_depth << 32 | static_cast<uint32_t>(clamped);
+}
+
+TranspositionEntry TranspositionTable::unpack(uint64_t data) {
+    TranspositionEntry entry;
+    entry.value = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.depth = static_cast<int>(data >> 32 & 0x7FFF);
+    return entry;
+}
+
+bool TranspositionTable::probe(uint64_t key, int min_depth, TranspositionEntry &out) const {
+    const Bucket &bucket = buckets[key & bucket_mask];
+    for (const Slot &slot : bucket.slots) {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        if (data && (slot.check.load(memory_order_relaxed) ^ data) == key) {
+            TranspositionEntry entry = unpack(data);
+            if (entry.depth < min_depth) return false;
+            out = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, long value, int depth) {
+    Bucket &bucket = buckets[key & bucket_mask];
+    uint64_t data = pack(value, depth);
+
+    // The key's own slot if it has one, else an empty slot, else the shallowest one
+    Slot *target = nullptr;
+    int target_depth = 0;
+    for (Slot &slot : bucket.slots) {
+        uint64_t old = slot.data.load(memory_order_relaxed);
+        if (old && (slot.check.load(memory_order_relaxed) ^ old) == key) {
+            if (unpack(old).depth > unpack(data).depth) return;
+            target = &slot;
+            break;
+        }
+        int old_depth = old ? unpack(old).depth : -1;
+        if (!target || old_depth < target_depth) {
+            target = &slot;
+            target_depth = old_depth;
+        }
+    }
+    target->check.store(key ^ data, memory_order_relaxed);
+    target->data.store(data, memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t b = 0; b <= bucket_mask; ++b) {
+        for (Slot &slot : buckets[b].slots) {
+            slot.data.store(0, memory_order_relaxed);
+            slot.check.store(0, memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+// Entries of a TranspositionTable bucket; four 16-byte entries fill one cache line
+#define TRANSPOSITION_BUCKET_SIZE 4
+
+// Default capacity of a TranspositionTable, in entries (16 MiB)
+#define TRANSPOSITION_DEFAULT_ENTRIES (1 << 20)
+
+// A value memoized for a state
+struct TranspositionEntry {
+    int32_t value;
+    int depth;  // How far ahead the value was searched, e.g. rollout ticks; deeper values are kept first
+};
+
+// Fixed-size cache of values by state hash (AsteroidDash::state_hash), e.g. Autopilot rollout values.
+// The table never grows: a key maps to one bucket, and a new key takes the bucket's empty or
+// shallowest entry. Any number of threads may probe and store at once without locks: each entry is
+// stored as its data and its key XOR its data, so an entry torn by a concurrent store no longer
+// matches its key and reads as a miss.
+class TranspositionTable {
+public:
+    // Rounds capacity down to a power of two number of buckets, at least one
+    explicit TranspositionTable(size_t capacity = TRANSPOSITION_DEFAULT_ENTRIES);
+
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+    // Looks a state up; returns false if it is not in the table or was only searched less than
+    // min_depth deep
+    bool probe(uint64_t key, int min_depth, TranspositionEntry &out) const;
+
+    // Records a state's value, unless the table already has it from a deeper search.
+    // Values are clamped to 32 bits and depths to 0..32767.
+    void store(uint64_t key, long value, int depth);
+
+    // Empties the table
+    void clear();
+
+    // Number of entries the table holds at most
+    size_t capacity() const { return (bucket_mask + 1) * TRANSPOSITION_BUCKET_SIZE; }
+
+private:
+    struct Slot {
+        atomic<uint64_t> check{0};  // key ^ data
+        atomic<uint64_t> data{0};   // 0 while empty, else TRANSPOSITION_USED | depth << 32 | value
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[TRANSPOSITION_BUCKET_SIZE];
+    };
+
+    static uint64_t pack(long value, int depth);
+    static TranspositionEntry unpack(uint64_t data);
+
+    unique_ptr<Bucket[]> buckets;
+    size_t bucket_mask = 0;
+};
+
+#endif // TRANSPOSITIONTABLE_H
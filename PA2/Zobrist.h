@@ -0,0 +1,32 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// What a Zobrist key stands for. The key of a state is the XOR of the keys of its features, so a
+// change of one feature is applied by XORing its old key out and its new key in.
+enum ZobristFeature {
+    ZOBRIST_TICK = 1,
+    ZOBRIST_PLAYER_ROW = 2,
+    ZOBRIST_PLAYER_COL = 3,
+    ZOBRIST_AMMO = 4,
+    ZOBRIST_LIVES = 5,
+    ZOBRIST_GAME_OVER = 6,
+    ZOBRIST_DAMAGE = 8,     // subject: store index, value: 64 * row + col of the cell
+    ZOBRIST_DESTROYED = 9   // subject: store index
+};
+
+// splitmix64 finalizer
+inline uint64_t zobrist_mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Key of a feature of a subject having a value. Keys are computed rather than read from random
+// tables, since a level can have millions of objects with thousands of cells each.
+inline uint64_t zobrist_key(ZobristFeature feature, uint64_t subject, uint64_t value) {
+    return zobrist_mix(zobrist_mix(subject * 0x9E3779B97F4A7C15ULL + feature) ^ value);
+}
+
+#endif // ZOBRIST_H
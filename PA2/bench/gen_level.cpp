@@ -0,0 +1,72 @@
+// Writes a synthetic level for the benchmarks: <prefix>_grid.dat, <prefix>_player.dat and
+// <prefix>_objects.dat, in the same formats the course levels use. Built and run from PA2:
+//
+//   g++ -std=c++17 -O2 -o gen_level bench/gen_level.cpp
+//   ./gen_level <prefix> [objects=100000] [grid_height=150] [grid_width=300] [seed=1]
+//
+// Objects are 1x1 to 8x8 shapes, about one in ten a power-up, spawning a few ticks apart in random
+// rows. The same seed always writes the same files.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <prefix> [objects=100000] [grid_height=150] [grid_width=300] [seed=1]"
+             << endl;
+        return 1;
+    }
+    string prefix = argv[1];
+    long objects = argc > 2 ? atol(argv[2]) : 100000;
+    int grid_height = argc > 3 ? atoi(argv[3]) : 150;
+    int grid_width = argc > 4 ? atoi(argv[4]) : 300;
+    unsigned seed = argc > 5 ? atoi(argv[5]) : 1;
+    if (objects < 0 || grid_height < 8 || grid_width < 8) {
+        cerr << "Error: Need at least 0 objects and an 8x8 grid" << endl;
+        return 1;
+    }
+
+    mt19937 engine(seed);
+
+    // Space grid: the loader only counts the cells, so every cell is empty
+    ofstream grid(prefix + "_grid.dat");
+    string grid_row;
+    for (int col = 0; col < grid_width; ++col) grid_row += col ? " 0" : "0";
+    for (int row = 0; row < grid_height; ++row) grid << grid_row << '\n';
+
+    // Player: the usual cross, halfway down the left edge
+    ofstream player(prefix + "_player.dat");
+    player << grid_height / 2 << " 0\n010\n111\n010\n";
+
+    ofstream out(prefix + "_objects.dat");
+    uniform_int_distribution<int> side(1, 8), start_row(0, grid_height - 1), gap(0, 3), kind(0, 19);
+    int tick = 0;
+    for (long i = 0; i < objects; ++i) {
+        int rows = side(engine), cols = side(engine);
+        int type = kind(engine);  // 0: life-up, 1: ammo, anything else: asteroid
+        char open = type < 2 ? '{' : '[', close = type < 2 ? '}' : ']';
+
+        // Random cells, with the first row's first cell set so no shape is empty
+        for (int row = 0; row < rows; ++row) {
+            if (row == 0) out << open;
+            for (int col = 0; col < cols; ++col) {
+                out << ((row == 0 && col == 0) || (engine() & 1) ? '1' : '0');
+            }
+            if (row == rows - 1) out << close;
+            out << '\n';
+        }
+        out << "s:" << start_row(engine) << "\nt:" << tick << '\n';
+        if (type < 2) out << "e:" << (type == 0 ? "life" : "ammo") << '\n';
+        out << '\n';
+        tick += gap(engine);
+    }
+
+    cout << "Wrote " << objects << " objects for a " << grid_height << "x" << grid_width << " grid to " << prefix
+         << "_*.dat" << endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Times loading and releasing a level, e.g. one written by gen_level. Built and run from PA2:
+//
+//   g++ -std=c++17 -O2 -I. -o level_bench bench/level_bench.cpp $(ls *.cpp) -lpthread
+//   ./gen_level /tmp/big && ./level_bench /tmp/big [runs=10]
+//
+// Each run loads <prefix>_grid.dat, <prefix>_objects.dat and <prefix>_player.dat into a fresh
+// LevelData and then destroys it. Prints the fastest and the median run of each, and how many heap
+// allocations and frees they made.
+
+#include "AsteroidDash.h"
+#include "LevelData.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Heap allocations and frees so far; new[] and delete[] go through these too
+static size_t allocations = 0, frees = 0;
+
+void *operator new(size_t size) {
+    ++allocations;
+    if (void *pointer = malloc(size ? size : 1)) return pointer;
+    throw bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    frees += pointer != nullptr;
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+static double elapsed_ms(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static void report(const string &what, vector<double> &times, double megabytes) {
+    sort(times.begin(), times.end());
+    double median = times[times.size() / 2];
+    cout << what << ": fastest " << times.front() << " ms, median " << median << " ms";
+    if (megabytes > 0) cout << " (" << megabytes / (median / 1000) << " MB/s)";
+    cout << endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <prefix> [runs=10]" << endl;
+        return 1;
+    }
+    string prefix = argv[1];
+    int runs = argc > 2 ? max(1, atoi(argv[2])) : 10;
+    string grid_file = prefix + "_grid.dat", objects_file = prefix + "_objects.dat";
+    string player_file = prefix + "_player.dat";
+
+    ifstream objects_in(objects_file, ios::binary | ios::ate);
+    if (!objects_in) {
+        cerr << "Error: Unable to open " << objects_file << endl;
+        return 1;
+    }
+    double megabytes = objects_in.tellg() / 1e6;
+
+    AsteroidDash::log_level = LOG_OFF;
+    vector<double> load_times, release_times;
+    int objects = 0;
+    size_t load_allocations = 0, release_frees = 0;
+    for (int run = 0; run < runs; ++run) {
+        size_t allocations_before = allocations;
+        auto start = chrono::steady_clock::now();
+        shared_ptr<LevelData> level = LevelData::load(grid_file, objects_file, player_file);
+        load_times.push_back(elapsed_ms(start));
+        load_allocations = allocations - allocations_before;
+        objects = level->object_count();
+
+        size_t frees_before = frees;
+        start = chrono::steady_clock::now();
+        level.reset();
+        release_times.push_back(elapsed_ms(start));
+        release_frees = frees - frees_before;
+    }
+
+    cout << objects << " celestial objects, " << megabytes << " MB, " << runs << " runs" << endl;
+    report("load", load_times, megabytes);
+    cout << "  " << load_allocations << " heap allocations" << endl;
+    report("release", release_times, 0);
+    cout << "  " << release_frees << " heap frees" << endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Times the headless engine: AsteroidDash::step with seeded random actions on a loaded level, e.g.
+// one written by gen_level. Built and run from PA2:
+//
+//   g++ -std=c++17 -O2 -I. -o tick_bench bench/tick_bench.cpp $(ls *.cpp) -lpthread
+//   ./gen_level /tmp/big && ./tick_bench /tmp/big [ticks=10000000] [seed=1]
+//
+// Collision rules are on, so objects cost lives, power-ups are collected and games end. A game that
+// ends is reset() and played again, so every tick counted is a real step. Prints the ticks per
+// second and the number of games the ticks were spread over.
+
+#include "AsteroidDash.h"
+#include "LevelData.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <prefix> [ticks=10000000] [seed=1]" << endl;
+        return 1;
+    }
+    string prefix = argv[1];
+    long ticks = argc > 2 ? atol(argv[2]) : 10000000;
+    unsigned seed = argc > 3 ? atoi(argv[3]) : 1;
+
+    AsteroidDash::log_level = LOG_OFF;
+    shared_ptr<LevelData> level =
+            LevelData::load(prefix + "_grid.dat", prefix + "_objects.dat", prefix + "_player.dat");
+    if (!level->has_player || level->grid_height == 0) {
+        cerr << "Error: Could not load the level " << prefix << "_*.dat" << endl;
+        return 1;
+    }
+    AsteroidDash game(level, "bench");
+    game.collision_rules = true;
+
+    // Actions are drawn up front so the timed loop measures the engine, not the random number generator
+    mt19937 engine(seed);
+    vector<GameAction> actions(1 << 16);
+    for (GameAction &action : actions) {
+        action = static_cast<GameAction>(engine() % ACTION_COUNT);
+    }
+
+    long games = 1;
+    unsigned long score = 0;
+    auto start = chrono::steady_clock::now();
+    for (long tick = 0; tick < ticks; ++tick) {
+        if (game.step(actions[tick & (actions.size() - 1)]).done) {
+            score += game.current_score;
+            game.reset();
+            ++games;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    score += game.current_score;
+
+    cout << level->object_count() << " celestial objects, " << level->grid_height << "x" << level->grid_width
+         << " grid" << endl;
+    cout << ticks << " ticks over " << games << " games in " << seconds << " s: " << ticks / seconds << " ticks/s"
+         << " (total score " << score << ")" << endl;
+    return 0;
+}